@@ -0,0 +1,136 @@
+/****************************************************************
+ * BENCHNETWORK.HPP
+ *
+ * This file contains the helpers shared by the benchmarks:
+ * network loading without Repast HPC and timing.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file BenchNetwork.hpp
+    \brief Benchmarks helpers (network loading and timing).
+ */
+
+#ifndef BENCHNETWORK_HPP_
+#define BENCHNETWORK_HPP_
+
+#include <chrono>
+#include <string>
+#include <iostream>
+#include <boost/lexical_cast.hpp>
+
+#include "../include/Network.hpp"
+#include "../include/tinyxml2.hpp"
+
+//! Load a road network in MATSim format.
+/*!
+  Reads the same attributes as Data::read_network_matsim, but keeps the
+  original node coordinates and does not require Repast HPC.
+
+  \param filename path to the network file
+  \return the indexed network
+ */
+inline Network benchLoadNetworkMatsim(const std::string& filename) {
+
+	Network net;
+	tinyxml2::XMLDocument doc;
+	doc.loadFile(filename.c_str());
+
+	tinyxml2::XMLElement * ele = doc.FirstChildElement("network")->FirstChildElement("nodes")->FirstChildElement("node");
+	while (ele) {
+		Node currNode(ele->StringAttribute("id"), ele->DoubleAttribute("x"), ele->DoubleAttribute("y"));
+		net.addNode(currNode);
+		ele = ele->NextSiblingElement("node");
+	}
+
+	ele = doc.FirstChildElement("network")->FirstChildElement("links")->FirstChildElement("link");
+	while (ele) {
+		std::string id         = ele->StringAttribute("id");
+		std::string start_node = ele->StringAttribute("from");
+		std::string end_node   = ele->StringAttribute("to");
+		net.addLinkOutToNode(start_node, id);
+		Link currLink(id, start_node, end_node, ele->FloatAttribute("length"), ele->FloatAttribute("freespeed"),
+				      ele->FloatAttribute("capacity"), net.getNodes().at(start_node).getX(), net.getNodes().at(start_node).getY());
+		net.addLink(currLink);
+		ele = ele->NextSiblingElement("link");
+	}
+
+	net.buildIndex();
+	return net;
+
+}
+
+//! Build a synthetic grid network of side x side nodes with 2-way links.
+/*!
+  \param side number of nodes on each side of the grid
+  \return the indexed network
+ */
+inline Network benchGridNetwork(int side) {
+
+	Network net;
+	auto node_id = [side](int i, int j) { return std::to_string(i * side + j); };
+
+	for( int i = 0; i < side; i++ )
+		for( int j = 0; j < side; j++ )
+			net.addNode(Node(node_id(i, j), 100.0 * j, 100.0 * i));
+
+	// links length and speed vary slightly to avoid too many ties
+	int n_links = 0;
+	auto add_link = [&](const std::string& from, const std::string& to) {
+		std::string id = std::to_string(n_links);
+		float length = 100.0f + (float)( ( (long)n_links * 7919 ) % 50 );
+		float speed  = 10.0f + (float)( ( (long)n_links * 104729 ) % 20 );
+		net.addLinkOutToNode(from, id);
+		net.addLink(Link(id, from, to, length, speed, 1800.0f, 0.0, 0.0));
+		n_links++;
+	};
+
+	for( int i = 0; i < side; i++ ) {
+		for( int j = 0; j < side; j++ ) {
+			if( j + 1 < side ) { add_link(node_id(i, j), node_id(i, j + 1)); add_link(node_id(i, j + 1), node_id(i, j)); }
+			if( i + 1 < side ) { add_link(node_id(i, j), node_id(i + 1, j)); add_link(node_id(i + 1, j), node_id(i, j)); }
+		}
+	}
+
+	net.buildIndex();
+	return net;
+
+}
+
+//! Load a network given on the command line.
+/*!
+  \param arg either a path to a MATSim network, or grid:N for a N x N grid
+  \return the indexed network
+ */
+inline Network benchNetwork(const std::string& arg) {
+
+	if( arg.compare(0, 5, "grid:") == 0 ) return benchGridNetwork(boost::lexical_cast<int>(arg.substr(5)));
+	return benchLoadNetworkMatsim(arg);
+
+}
+
+//! Simple wall clock timer.
+class BenchTimer {
+
+private:
+
+	std::chrono::steady_clock::time_point _start;   //!< starting time
+
+public:
+
+	//! Constructor, starts the timer.
+	BenchTimer() : _start(std::chrono::steady_clock::now()) {};
+
+	//! Restart the timer.
+	void start() {
+		_start = std::chrono::steady_clock::now();
+	}
+
+	//! Return the number of seconds elapsed since the timer started.
+	double elapsed() const {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+	}
+
+};
+
+#endif /* BENCHNETWORK_HPP_ */
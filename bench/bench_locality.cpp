@@ -0,0 +1,118 @@
+/****************************************************************
+ * BENCH_LOCALITY.CPP
+ *
+ * Benchmark of the nodes and links numbering: routing queries
+ * and link state updates throughput for every nodes ordering.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file bench_locality.cpp
+ *  \brief Routing and link updates throughput for the id, Hilbert and RCM orders.
+ */
+
+#include <vector>
+#include <iomanip>
+#include "BenchNetwork.hpp"
+
+using namespace std;
+
+void usage() {
+	cerr << "usage: bench_locality network [n_queries] [n_agents]" << endl;
+	cerr << "  network: path to a MATSim network file, or grid:N for a N x N grid" << endl;
+	cerr << "  n_queries: number of one-to-all trees computed per order (default 32)" << endl;
+	cerr << "  n_agents: number of agents moving along their path (default 100000)" << endl;
+}
+
+int main(int argc, char ** argv) {
+
+	if( argc < 2 ) {
+		usage();
+		return EXIT_FAILURE;
+	}
+
+	int n_queries = argc > 2 ? boost::lexical_cast<int>(argv[2]) : 32;
+	int n_agents  = argc > 3 ? boost::lexical_cast<int>(argv[3]) : 100000;
+
+	Network net = benchNetwork(argv[1]);
+	cout << "Network: " << net.getNNodesIndexed() << " nodes, " << net.getNLinksIndexed() << " links" << endl;
+
+	// Queries and agents are defined by ids, so that they are the same for every order
+	vector<std::string> sources;                                   // also the agents origins
+	vector<std::string> destinations;
+	unsigned long rnd = 12345;
+	auto next_node = [&rnd, &net]() {
+		rnd = rnd * 6364136223846793005UL + 1442695040888963407UL;
+		return net.getNodeIdByIndex( (int)( ( rnd >> 33 ) % net.getNNodesIndexed() ) );
+	};
+	for( int q = 0; q < n_queries; q++ ) sources.push_back(next_node());
+	for( int a = 0; a < n_agents; a++ ) destinations.push_back(next_node());
+
+	cout << setw(10) << "order" << setw(14) << "ms/query" << setw(20) << "M link updates/s" << endl;
+
+	const vector<pair<NodeOrder, std::string>> orders = { {NodeOrder::ID, "id"}, {NodeOrder::HILBERT, "hilbert"}, {NodeOrder::RCM, "rcm"} };
+	for( const auto& order : orders ) {
+
+		BenchTimer timer;
+		net.setNodeOrder(order.first);
+		net.buildIndex();
+		double time_index = timer.elapsed();
+
+		vector<float> cost = net.getLinksTime();
+		vector<float> dist;
+		vector<int>   pred;
+
+		// Routing queries
+
+		timer.start();
+		for( const auto& s : sources ) net.computeTree(net.getNodeIndex(s), cost, dist, pred);
+		double time_query = timer.elapsed() / n_queries;
+
+		// Agents paths (links index), agent a starting from source a % n_queries
+
+		vector<vector<int>> paths(n_agents);
+		for( int q = 0; q < n_queries; q++ ) {
+			net.computeTree(net.getNodeIndex(sources[q]), cost, dist, pred);
+			for( int a = q; a < n_agents; a += n_queries ) {
+				int n = net.getNodeIndex(destinations[a]);
+				while( pred[n] >= 0 ) {
+					paths[a].push_back(pred[n]);
+					n = net.getLinkStartIndex(pred[n]);
+				}
+			}
+		}
+
+		// Link state updates: every agent leaves its link, enters the next one and reads its travel time
+
+		vector<unsigned int> n_on_link(net.getNLinksIndexed(), 0);
+		vector<float> capacity(net.getNLinksIndexed());
+		for( int l = 0; l < net.getNLinksIndexed(); l++ ) capacity[l] = net.getLinks().at(net.getLinkIdByIndex(l)).getCapacity();
+
+		long   n_updates = 0;
+		double sum_time  = 0.0;
+		bool   moving    = true;
+		timer.start();
+		for( size_t step = 0; moving == true; step++ ) {
+			moving = false;
+			for( int a = 0; a < n_agents; a++ ) {
+				const vector<int>& p = paths[a];
+				if( step >= p.size() ) continue;
+				moving = true;
+				if( step > 0 ) n_on_link[p[p.size() - step]]--;
+				int l = p[p.size() - 1 - step];
+				n_on_link[l]++;
+				float ratio = n_on_link[l] / capacity[l];
+				sum_time += cost[l] * ( 1.0f + 0.15f * ratio * ratio * ratio * ratio );
+				n_updates++;
+			}
+		}
+		double time_updates = timer.elapsed();
+
+		cout << setw(10) << order.second << setw(14) << time_query * 1000.0 << setw(20) << n_updates / time_updates / 1e6
+			 << "   (index built in " << time_index << " s, checksum " << sum_time << ")" << endl;
+
+	}
+
+	return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,225 @@
+/****************************************************************
+ * BENCH_ROUTES.CPP
+ *
+ * Replay of a log of routing requests (par.route_log) against
+ * routing engines and paths cache sizes.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file bench_routes.cpp
+ *  \brief Total time and latency percentiles of the logged routing requests per engine.
+ *
+ *  The requests of the log are mapped on the network of the replay by their
+ *  nodes and links ids, and answered in their order by every engine:
+ *  - recorded: the algorithm of the log (A*, Dijkstra, Dijkstra avoiding a
+ *    link), the link times table costs being replaced by the free flow
+ *    times and the partition overlay by A*; the requests found in the look
+ *    up table or the near cache by the simulation are looked up among the
+ *    paths computed before by the replay (A* if none);
+ *  - astar, dijkstra, table: the given algorithm for every request without
+ *    a link to avoid (table: Dijkstra on a costs vector of the free flow
+ *    times), the others avoiding their link, cached requests included;
+ *  - cache:N: the recorded engine behind a near cache of N paths (least
+ *    recently used evicted), as the one of the distributed routes cache.
+ */
+
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <unordered_map>
+#include "../include/RouteLog.hpp"
+#include "../include/RouteCache.hpp"
+#include "BenchNetwork.hpp"
+
+using namespace std;
+
+void usage() {
+	cerr << "usage: bench_routes network routes.bin [engine ...]" << endl;
+	cerr << "  network: path to the MATSim network file of the simulation, or grid:N for a N x N grid" << endl;
+	cerr << "  routes.bin: log of the routing requests of a process (par.route_log = y)" << endl;
+	cerr << "  engine: recorded, astar, dijkstra, table or cache:N (default: recorded astar dijkstra table cache:10000)" << endl;
+}
+
+//! Request of the log mapped on the network of the replay.
+struct BenchRoute {
+  std::string  source;   //!< source node id
+  std::string  dest;     //!< destination node id
+  std::string  avoid;    //!< link to avoid id (none if empty)
+  RouteMetric  metric;   //!< algorithm of the log
+};
+
+//! Print the total time and latency percentiles (s) of a set of requests.
+void printLatencies(const std::string& name, vector<double> latencies, double total, const std::string& extra = "") {
+
+	if( latencies.empty() == true ) {
+		cout << setw(20) << left << name << "no requests" << endl;
+		return;
+	}
+
+	sort(latencies.begin(), latencies.end());
+	auto percentile = [&latencies](double p) { return latencies[ min(latencies.size() - 1, (size_t)( p * latencies.size() )) ] * 1e6; };
+
+	cout << setw(20) << left << name << right << fixed << setprecision(3)
+		 << setw(12) << total
+		 << setw(12) << total * 1e6 / latencies.size()
+		 << setw(12) << percentile(0.5)
+		 << setw(12) << percentile(0.9)
+		 << setw(12) << percentile(0.99)
+		 << setw(12) << latencies.back() * 1e6
+		 << "  " << extra << endl;
+
+}
+
+int main(int argc, char ** argv) {
+
+	if( argc < 3 ) {
+		usage();
+		return EXIT_FAILURE;
+	}
+
+	Network net = benchNetwork(argv[1]);
+	cout << "Network: " << net.getNNodesIndexed() << " nodes, " << net.getNLinksIndexed() << " links" << endl;
+
+	vector<std::string> log_nodes, log_links;
+	vector<RouteRecord> records;
+	if( RouteLog::read(argv[2], log_nodes, log_links, records) == false ) {
+		cerr << "Could not read the routing requests of " << argv[2] << endl;
+		return EXIT_FAILURE;
+	}
+
+	vector<std::string> engines;
+	for( int a = 3; a < argc; a++ ) engines.push_back(argv[a]);
+	if( engines.empty() == true ) engines = { "recorded", "astar", "dijkstra", "table", "cache:10000" };
+
+	// Requests mapped by ids, the ones with nodes unknown to the replay network being skipped
+	static const char * site_names[] = { "initial", "departure", "next_trip", "reroute", "tree_exit", "published" };
+	vector<BenchRoute> routes;
+	vector<double>     recorded[6];
+	double             recorded_total[6] = { 0.0 };
+	unsigned int       recorded_hits[6]  = { 0 };
+	unsigned int       n_skipped = 0, n_avoid_unknown = 0;
+	for( const auto& r : records ) {
+		if( r.site > 5 || r.source < 0 || r.dest < 0 || r.source >= (int)log_nodes.size() || r.dest >= (int)log_nodes.size() ||
+			net.getNodes().count(log_nodes[r.source]) == 0 || net.getNodes().count(log_nodes[r.dest]) == 0 ) {
+			n_skipped++;
+			continue;
+		}
+		BenchRoute route;
+		route.source = log_nodes[r.source];
+		route.dest   = log_nodes[r.dest];
+		route.metric = (RouteMetric)r.metric;
+		if( r.avoid >= 0 && r.avoid < (int)log_links.size() ) {
+			if( net.getLinks().count(log_links[r.avoid]) == 1 ) route.avoid = log_links[r.avoid];
+			else                                                n_avoid_unknown++;
+		}
+		routes.push_back(route);
+		recorded[r.site].push_back(r.latency * 1e-9);
+		recorded_total[r.site] += r.latency * 1e-9;
+		if( route.metric == RouteMetric::CACHED ) recorded_hits[r.site]++;
+	}
+
+	cout << "Requests: " << records.size() << " logged, " << routes.size() << " replayed (" << n_skipped << " with unknown nodes, "
+		 << n_avoid_unknown << " with an unknown link to avoid, replayed without it)" << endl << endl;
+
+	cout << setw(20) << left << "" << right << setw(12) << "total (s)" << setw(12) << "mean (us)" << setw(12) << "p50 (us)"
+		 << setw(12) << "p90 (us)" << setw(12) << "p99 (us)" << setw(12) << "max (us)" << endl;
+
+	// Latencies measured by the simulation, per call site (the published requests are computed in batches)
+	for( int s = 0; s < 5; s++ ) {
+		ostringstream hits;
+		if( recorded[s].empty() == false ) hits << fixed << setprecision(1) << "hit rate " << 100.0 * recorded_hits[s] / recorded[s].size() << "%";
+		printLatencies(std::string("logged ") + site_names[s], recorded[s], recorded_total[s], hits.str());
+	}
+	if( recorded[5].empty() == false ) cout << setw(20) << left << "logged published" << recorded[5].size() << " requests computed in batches" << endl;
+	cout << endl;
+
+	// Free flow costs, standing for the link times table
+	vector<float> cost(net.getNLinksIndexed());
+	for( int l = 0; l < net.getNLinksIndexed(); l++ ) cost[l] = net.getLinks().at(net.getLinkIdByIndex(l)).getFreeFlowTime();
+
+	auto compute = [&net, &cost](const BenchRoute& route, RouteMetric metric) {
+		if( route.avoid.empty() == false )  return net.computePath(route.source, route.dest, route.avoid);
+		if( metric == RouteMetric::DIJKSTRA ) return net.computePath(route.source, route.dest);
+		if( metric == RouteMetric::TABLE )    return net.computePath(route.source, route.dest, cost);
+		return net.computePathAStar(route.source, route.dest);
+	};
+
+	auto key = [&net](const BenchRoute& route) {
+		return (long)net.getNodeIndex(route.source) * net.getNNodesIndexed() + net.getNodeIndex(route.dest);
+	};
+
+	for( const auto& engine : engines ) {
+
+		bool         use_cache = engine.compare(0, 6, "cache:") == 0;
+		PathStore    cache(use_cache == true ? boost::lexical_cast<unsigned int>(engine.substr(6)) : 0);
+		RouteMetric  metric    = RouteMetric::ASTAR;
+		if( engine.compare("dijkstra") == 0 ) metric = RouteMetric::DIJKSTRA;
+		else if( engine.compare("table") == 0 ) metric = RouteMetric::TABLE;
+		else if( engine.compare("astar") != 0 && engine.compare("recorded") != 0 && use_cache == false ) {
+			cerr << "Unknown engine " << engine << endl;
+			usage();
+			return EXIT_FAILURE;
+		}
+		bool recorded_metric = engine.compare("recorded") == 0 || use_cache == true;
+
+		vector<double> latencies;
+		latencies.reserve(routes.size());
+		unsigned int   n_hits = 0;
+		unordered_map<long, vector<int>> recorded_paths;   // paths computed by the recorded engine, for its cached requests
+		BenchTimer     timer_total;
+		for( const auto& route : routes ) {
+
+			BenchTimer timer;
+			RouteMetric m = recorded_metric == true ? route.metric : metric;
+			vector<std::string> path;
+
+			// paths avoiding a link are never cached, as by the model
+			if( use_cache == true && route.avoid.empty() == true ) {
+				const vector<int>* p = cache.find(key(route));
+				if( p != NULL ) {
+					for( int l : *p ) path.push_back(net.getLinkIdByIndex(l));
+					n_hits++;
+				}
+				else {
+					path = compute(route, m);
+					vector<int> links;
+					for( const auto& l : path ) links.push_back(net.getLinkIndex(l));
+					cache.insert(key(route), links);
+				}
+			}
+			else if( use_cache == false && recorded_metric == true && route.avoid.empty() == true ) {
+				auto it = route.metric == RouteMetric::CACHED ? recorded_paths.find(key(route)) : recorded_paths.end();
+				if( it != recorded_paths.end() ) {
+					for( int l : it->second ) path.push_back(net.getLinkIdByIndex(l));
+				}
+				else {
+					path = compute(route, m);
+					vector<int>& links = recorded_paths[key(route)];
+					links.clear();
+					for( const auto& l : path ) links.push_back(net.getLinkIndex(l));
+				}
+			}
+			else {
+				path = compute(route, m);
+			}
+
+			latencies.push_back(timer.elapsed());
+
+		}
+		double total = timer_total.elapsed();
+
+		std::string extra;
+		if( use_cache == true && routes.empty() == false ) {
+			ostringstream hits;
+			hits << fixed << setprecision(1) << "hit rate " << 100.0 * n_hits / routes.size() << "%";
+			extra = hits.str();
+		}
+		printLatencies(engine, latencies, total, extra);
+
+	}
+
+	return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,103 @@
+/****************************************************************
+ * BENCH_SSSP.CPP
+ *
+ * Benchmark of the one-to-all shortest path trees: serial
+ * Dijkstra against parallel delta-stepping for an increasing
+ * number of threads.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file bench_sssp.cpp
+ *  \brief Thread scaling of delta-stepping against serial Dijkstra.
+ */
+
+#include <vector>
+#include <iomanip>
+#include "BenchNetwork.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+void usage() {
+	cerr << "usage: bench_sssp network [n_sources] [max_threads]" << endl;
+	cerr << "  network: path to a MATSim network file, or grid:N for a N x N grid" << endl;
+	cerr << "  n_sources: number of trees computed per configuration (default 16)" << endl;
+	cerr << "  max_threads: largest number of threads tested (default: all)" << endl;
+}
+
+int main(int argc, char ** argv) {
+
+	if( argc < 2 ) {
+		usage();
+		return EXIT_FAILURE;
+	}
+
+	int n_sources   = argc > 2 ? boost::lexical_cast<int>(argv[2]) : 16;
+	int max_threads = 1;
+#ifdef _OPENMP
+	max_threads = omp_get_max_threads();
+#endif
+	if( argc > 3 ) max_threads = boost::lexical_cast<int>(argv[3]);
+
+	BenchTimer timer;
+	Network net = benchNetwork(argv[1]);
+	cout << "Network: " << net.getNNodesIndexed() << " nodes, " << net.getNLinksIndexed() << " links (loaded in "
+		 << timer.elapsed() << " s)" << endl;
+
+	vector<float> cost = net.getLinksTime();
+	float delta = net.deltaSteppingWidth(cost);
+	cout << "Bucket width: " << delta << endl;
+
+	// sources spread over the node indices
+	vector<int> sources;
+	for( int s = 0; s < n_sources; s++ ) sources.push_back( (int)( (long)s * net.getNNodesIndexed() / n_sources ) );
+
+	// Reference: serial Dijkstra
+
+	vector<vector<float>> ref_dist(n_sources);
+	vector<vector<int>>   ref_pred(n_sources);
+
+	timer.start();
+	for( int s = 0; s < n_sources; s++ ) net.computeTree(sources[s], cost, ref_dist[s], ref_pred[s]);
+	double time_dijkstra = timer.elapsed() / n_sources;
+
+	cout << setw(12) << "algorithm" << setw(10) << "threads" << setw(14) << "ms/tree" << setw(10) << "speedup" << setw(10) << "same" << endl;
+	cout << setw(12) << "dijkstra" << setw(10) << 1 << setw(14) << time_dijkstra * 1000.0 << setw(10) << 1.0 << setw(10) << "-" << endl;
+
+	// Delta-stepping for 1, 2, 4, ... threads, and max_threads
+
+	vector<int> threads;
+	for( int n_threads = 1; n_threads < max_threads; n_threads *= 2 ) threads.push_back(n_threads);
+	threads.push_back(max_threads);
+
+	for( int n_threads : threads ) {
+
+#ifdef _OPENMP
+		omp_set_num_threads(n_threads);
+#endif
+
+		vector<float> dist;
+		vector<int>   pred;
+		bool   same = true;
+		double time_delta = 0.0;
+
+		for( int s = 0; s < n_sources; s++ ) {
+			timer.start();
+			net.computeTreeDeltaStepping(sources[s], cost, dist, pred, delta);
+			time_delta += timer.elapsed();
+			if( dist != ref_dist[s] || pred != ref_pred[s] ) same = false;
+		}
+		time_delta /= n_sources;
+
+		cout << setw(12) << "delta" << setw(10) << n_threads << setw(14) << time_delta * 1000.0
+			 << setw(10) << time_dijkstra / time_delta << setw(10) << ( same ? "yes" : "NO" ) << endl;
+
+	}
+
+	return EXIT_SUCCESS;
+
+}
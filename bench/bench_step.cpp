@@ -0,0 +1,260 @@
+/****************************************************************
+ * BENCH_STEP.CPP
+ *
+ * Benchmark of the simulation step alone, without MPI nor Repast
+ * HPC (single process build): synthetic grid network and agents
+ * with known paths, stepped for a given number of ticks.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file bench_step.cpp
+ *  \brief Time, allocations and cache misses per agent and tick of Model::step.
+ *
+ *  The agents cross a grid network of side N along known paths of N links
+ *  (from their node to the opposite one, row then column), imported as
+ *  MATSim routes. The controls are given as properties on the command line:
+ *  - bench.agents: number of agents;
+ *  - bench.grid: side of the grid;
+ *  - bench.ticks: number of steps measured;
+ *  - bench.en_route: fraction of the agents leaving at the first tick, the
+ *    others waiting for a departure after the last tick;
+ *  - bench.congestion: mean ratio between the agents on a link and its
+ *    capacity (0 = free flow);
+ *  - par.prop_strategic_agents: fraction of the strategic agents, as any
+ *    other model property.
+ *
+ *  The network and the population are written in a temporary directory,
+ *  which also receives the outputs of the model, the model reading its
+ *  inputs from files. Only the calls to Model::step are measured, the cache
+ *  misses being the ones of the main thread.
+ */
+
+#include <new>
+#include <atomic>
+#include <vector>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "repast_hpc/RepastProcess.h"
+#include "repast_hpc/Properties.h"
+#include "../include/Model.hpp"
+#include "../include/Data.hpp"
+#include "../include/Random.hpp"
+#include "../include/PerfCounter.hpp"
+#include "BenchNetwork.hpp"
+
+using namespace std;
+
+// Allocations counted by the global operator new --------------------------
+
+static atomic<unsigned long> bench_n_allocs(0);
+static atomic<unsigned long> bench_alloc_bytes(0);
+
+void * operator new(size_t size) {
+	bench_n_allocs++;
+	bench_alloc_bytes += size;
+	void * p = malloc(size == 0 ? 1 : size);
+	if( p == NULL ) throw std::bad_alloc();
+	return p;
+}
+
+// (operator new being replaced too, free matches the allocations)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void operator delete(void * p) noexcept {
+	free(p);
+}
+
+void operator delete(void * p, size_t) noexcept {
+	free(p);
+}
+
+#pragma GCC diagnostic pop
+
+void usage() {
+	cerr << "usage: bench_step model.props [key=value ...]" << endl;
+	cerr << "  model.props: model properties (the network, trips and time window ones are replaced)" << endl;
+	cerr << "  bench.agents=N: number of agents (default 100000)" << endl;
+	cerr << "  bench.grid=N: side of the grid network (default 100)" << endl;
+	cerr << "  bench.ticks=K: number of steps measured (default 300)" << endl;
+	cerr << "  bench.en_route=F: fraction of the agents on the road (default 1)" << endl;
+	cerr << "  bench.congestion=R: mean agents / capacity ratio of the links (default 0.5, 0 = free flow)" << endl;
+	cerr << "  bench.keep=y: keep the temporary directory of the inputs and outputs" << endl;
+	cerr << "  any other key=value overrides a model property, e.g. par.prop_strategic_agents=0.1" << endl;
+}
+
+//! Return a property of the benchmark, or its default value.
+template <typename T>
+T benchProperty(const repast::Properties& props, const std::string& key, T value) {
+	if( props.contains(key) ) return boost::lexical_cast<T>(props.getProperty(key));
+	return value;
+}
+
+//! Format a time of the day (s) as hh:mm:ss.
+std::string benchTimeOfDay(int t) {
+	char buffer[16];
+	snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d", t / 3600, ( t / 60 ) % 60, t % 60);
+	return buffer;
+}
+
+//! Write a grid network of side x side nodes with 2-way links in MATSim format.
+void writeGridNetwork(const std::string& filename, int side, float capacity) {
+
+	ofstream file(filename.c_str(), ios::out);
+	file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << endl << "<network>" << endl << "<nodes>" << endl;
+	for( int i = 0; i < side; i++ )
+		for( int j = 0; j < side; j++ )
+			file << "<node id=\"" << i * side + j << "\" x=\"" << 100.0 * j << "\" y=\"" << 100.0 * i << "\" />" << endl;
+	file << "</nodes>" << endl << "<links>" << endl;
+
+	// 100 m links at 10 m/s, a link being crossed in 10 ticks at free flow
+	int n_links = 0;
+	auto add_link = [&](int from, int to) {
+		file << "<link id=\"" << n_links++ << "\" from=\"" << from << "\" to=\"" << to << "\" length=\"100\" freespeed=\"10\" capacity=\""
+			 << capacity << "\" />" << endl;
+	};
+	for( int i = 0; i < side; i++ ) {
+		for( int j = 0; j < side; j++ ) {
+			if( j + 1 < side ) { add_link(i * side + j, i * side + j + 1); add_link(i * side + j + 1, i * side + j); }
+			if( i + 1 < side ) { add_link(i * side + j, ( i + 1 ) * side + j); add_link(( i + 1 ) * side + j, i * side + j); }
+		}
+	}
+	file << "</links>" << endl << "</network>" << endl;
+
+}
+
+//! Write the agents, every agent crossing the grid along a known path (row, then column).
+void writePopulation(const std::string& filename, int side, int n_agents, float en_route, int ticks) {
+
+	ofstream file(filename.c_str(), ios::out);
+	file << "<?xml version=\"1.0\" ?>" << endl << "<plans>" << endl;
+
+	unsigned long rnd = 12345;
+	int n_en_route = (int)( en_route * n_agents + 0.5f );
+	for( int a = 0; a < n_agents; a++ ) {
+
+		rnd = rnd * 6364136223846793005UL + 1442695040888963407UL;
+		int origin = (int)( ( rnd >> 33 ) % ( side * side ) );
+		int oi = origin / side, oj = origin % side;
+		int di = ( oi + side / 2 ) % side, dj = ( oj + side / 2 ) % side;
+
+		std::string route;
+		for( int j = oj; j != dj; j += ( dj > oj ? 1 : -1 ) ) route += to_string(oi * side + j) + " ";
+		for( int i = oi; i != di; i += ( di > oi ? 1 : -1 ) ) route += to_string(i * side + dj) + " ";
+		route += to_string(di * side + dj);
+
+		int departure = a < n_en_route ? 0 : ticks + 60;
+		file << "<person id=\"" << a << "\"><plan><act type=\"h\" node_id=\"" << origin << "\" end_time=\"" << benchTimeOfDay(departure)
+			 << "\" /><leg mode=\"car\"><route type=\"nodes\">" << route << "</route></leg><act type=\"w\" node_id=\""
+			 << di * side + dj << "\" /></plan></person>" << endl;
+
+	}
+	file << "</plans>" << endl;
+
+}
+
+int main(int argc, char ** argv) {
+
+	if( argc < 2 ) {
+		usage();
+		return EXIT_FAILURE;
+	}
+
+	boost::mpi::environment  env(argc, argv);
+	boost::mpi::communicator world;
+	repast::RepastProcess::init("", &world);
+	RandomGenerators::makeInstance(0);
+
+	repast::Properties props(argv[1], argc, argv, &world);
+	int   n_agents   = benchProperty<int>(props, "bench.agents", 100000);
+	int   side       = benchProperty<int>(props, "bench.grid", 100);
+	int   ticks      = benchProperty<int>(props, "bench.ticks", 300);
+	float en_route   = benchProperty<float>(props, "bench.en_route", 1.0f);
+	float congestion = benchProperty<float>(props, "bench.congestion", 0.5f);
+	if( side < 2 || n_agents < 1 || ticks < 1 || en_route < 0.0f || en_route > 1.0f || congestion < 0.0f ) {
+		usage();
+		return EXIT_FAILURE;
+	}
+
+	// Inputs and outputs in a temporary directory -------------------------
+
+	boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("bench_step_%%%%%%");
+	boost::filesystem::create_directories(dir / "bin");
+	boost::filesystem::create_directories(dir / "output");
+	if( props.contains("file.strategies") ) props.putProperty("file.strategies", boost::filesystem::absolute(props.getProperty("file.strategies")).string());
+	boost::filesystem::current_path(dir / "bin");
+
+	// ... capacity giving the congestion ratio when the agents are evenly spread on the links
+	int   n_links  = 4 * side * ( side - 1 );
+	float capacity = congestion > 0.0f ? en_route * n_agents / n_links / congestion : 1e9f;
+	writeGridNetwork("network.xml", side, max(capacity, 1.0f));
+	writePopulation("population.xml", side, n_agents, en_route, ticks);
+
+	props.putProperty("par.network_format", "matsim");
+	props.putProperty("file.network_matsim", "network.xml");
+	props.putProperty("file.trips_matsim", "population.xml");
+	props.putProperty("file.warm_start", "");
+	props.putProperty("par.proc_x", "1");
+	props.putProperty("par.proc_y", "1");
+	props.putProperty("par.start_time", "0");
+	props.putProperty("par.end_time", "0");
+
+	// Model ---------------------------------------------------------------
+
+	Data::makeInstance(props);
+	Model * model = new Model(&world, props);
+
+	// Steps ---------------------------------------------------------------
+
+	PerfCounter misses;
+	bool has_misses = misses.open();
+
+	double        time          = 0.0;
+	unsigned long agent_ticks   = 0;
+	unsigned long n_allocs      = 0;
+	unsigned long alloc_bytes   = 0;
+	unsigned long n_en_route    = 0;
+	for( int t = 0; t < ticks; t++ ) {
+
+		agent_ticks += model->agents->size();
+		for( auto it = model->agents->localBegin(); it != model->agents->localEnd(); it++ ) n_en_route += (*it)->isEnRoute() == true ? 1 : 0;
+
+		unsigned long allocs_start = bench_n_allocs, bytes_start = bench_alloc_bytes;
+		if( has_misses == true ) misses.start();
+		BenchTimer timer;
+		model->step();
+		time += timer.elapsed();
+		if( has_misses == true ) misses.stop();
+		n_allocs    += bench_n_allocs - allocs_start;
+		alloc_bytes += bench_alloc_bytes - bytes_start;
+
+	}
+
+	cout << "Grid " << side << " x " << side << ", " << n_agents << " agents (" << en_route * 100.0f << "% leaving at the first tick, "
+		 << props.getProperty("par.prop_strategic_agents") << " strategic), congestion " << congestion << ", " << ticks << " ticks" << endl;
+	cout << fixed << setprecision(2);
+	cout << setw(28) << left << "mean agents en route:" << (double)n_en_route / ticks << endl;
+	cout << setw(28) << left << "ns / agent-tick:" << time * 1e9 / agent_ticks << endl;
+	cout << setw(28) << left << "allocations / agent-tick:" << (double)n_allocs / agent_ticks << endl;
+	cout << setw(28) << left << "bytes allocated / tick:" << (double)alloc_bytes / ticks << endl;
+	if( has_misses == true ) cout << setw(28) << left << "cache misses / agent-tick:" << (double)misses.getTotal() / agent_ticks << endl;
+	else                     cout << setw(28) << left << "cache misses / agent-tick:" << "unavailable (perf events)" << endl;
+
+	delete model;
+	Data::getInstance()->kill();
+	RandomGenerators::getInstance()->kill();
+
+	boost::filesystem::current_path(dir.parent_path());
+	if( props.contains("bench.keep") && props.getProperty("bench.keep").compare("y") == 0 ) cout << "Inputs and outputs kept in " << dir.string() << endl;
+	else                                                                                     boost::filesystem::remove_all(dir);
+
+	repast::RepastProcess::instance()->done();
+
+	return EXIT_SUCCESS;
+
+}
@@ -22,16 +22,20 @@
 #include <repast_hpc/RepastProcess.h>
 #include <repast_hpc/TDataSource.h>
 #include "repast_hpc/SVDataSet.h"
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "Network.hpp"
+#include "NodeLocator.hpp"
 #include "Random.hpp"
 #include "Strategy.hpp"
 #include "tinyxml2.hpp"
@@ -103,6 +107,7 @@ class Data : public Singleton<Data> {
 private:
 
 	Network               _network;           //!< road network.
+	NodeLocator           _node_locator;      //!< spatial index of the nodes of the whole road network (matsim input, not built if sharded).
 	repast::Properties    _props;             //!< properties of simulation.
 	std::map<std::string, std::string>  _map_act_loc_nodes; //!< map linking the activities id to the road network node (transim input).
 	std::map<std::string, std::string>  _map_2way_links;    //!< map in which each key is an id of a link A->B and the value is the id of link B->A (transim input).
@@ -133,10 +138,33 @@ public:
 			read_network_transims();
 		}
 
+		// Cleaning: only the largest strongly connected component is kept (the components of a sharded network are not known)
+
+		if( _props.contains("par.largest_component") && _props.getProperty("par.largest_component").compare("y") == 0 && isSharded() == true ) {
+			if (repast::RepastProcess::instance()->rank() == 0) cout << "WARNING: par.largest_component is ignored with a sharded network" << endl;
+		}
+		else if( _props.contains("par.largest_component") && _props.getProperty("par.largest_component").compare("y") == 0 ) {
+			_network.buildIndex();
+			int n_components = _network.getNComponents();
+			unsigned int n_removed = _network.restrictToLargestComponent();
+			if (repast::RepastProcess::instance()->rank() == 0) {
+				cout << "       largest of " << n_components << " strongly connected components kept, ";
+				cout << n_removed << " nodes removed" << endl;
+			}
+		}
+
+		if (this->_props.getProperty("par.network_format").compare("matsim") == 0 && isSharded() == false ) _node_locator.build(_network);
+
+		if( this->_props.getProperty("par.node_order").compare("hilbert") == 0 ) _network.setNodeOrder(NodeOrder::HILBERT);
+		if( this->_props.getProperty("par.node_order").compare("rcm") == 0 )     _network.setNodeOrder(NodeOrder::RCM);
+		_network.buildIndex();
+
 		if (repast::RepastProcess::instance()->rank() == 0) {
 			cout << "       network bounding box: x min " << _network.getMinX() << ", x max " << _network.getMaxX();
 			cout << ", y min " << _network.getMinY() << ", y max " << _network.getMaxY() << endl;
-			cout << "       network contains " << _network.getLinks().size() << " links and " << _network.getNodes().size() << " nodes" << endl;
+			if( isSharded() == true ) cout << "       partition of process 0 contains ";
+			else                      cout << "       network contains ";
+			cout << _network.getLinks().size() << " links and " << _network.getNodes().size() << " nodes" << endl;
 		}
 
 		// Agents strategies
@@ -154,9 +182,43 @@ public:
 	//! Read the road network (transims format).
 	void read_network_transims();
 
+	//! Function called with the id and the coordinates of a node read.
+	typedef std::function<void(const std::string&, double, double)> NodeVisitor;
+
+	//! Function called with a link read.
+	typedef std::function<void(const Link&)> LinkVisitor;
+
+	//! Read the partition of the road network of the process (sharded network).
+	/*!
+      The nodes are read several times, so that the whole network is never stored: once
+      for the bounding box, once for their positions along the Hilbert curve, giving the
+      range of every process (see Network::setPartition), and once to keep the nodes of
+      the partition. The links entering or leaving the partition are then kept, with the
+      nodes at their other end.
+
+      \param read_nodes function calling its argument on every node of the network
+      \param read_links function calling its argument on every link of the network
+	 */
+	void read_network_partition(const std::function<void(const NodeVisitor&)>& read_nodes,
+	                            const std::function<void(const LinkVisitor&)>& read_links);
+
+	//! Fill a spatial index with every node of the network file (matsim input).
+	/*!
+      A sharded network not holding the whole network, the nodes and links are streamed
+      from the network file instead.
+
+      \param locator the spatial index to fill
+	 */
+	void read_node_locator(NodeLocator& locator) const;
+
 	//! Read the agents strategies.
 	void read_strategies();
 
+	//! Check whether every process only stores its partition of the network.
+	bool isSharded() const {
+		return _props.contains("par.shard_network") && _props.getProperty("par.shard_network").compare("y") == 0;
+	}
+
 	//! Return the road network.
 	/*!
       \return a road network
@@ -165,6 +227,11 @@ public:
 		return _network;
 	}
 
+	//! Return the spatial index of the nodes of the whole road network (matsim input, empty if sharded).
+	const NodeLocator & getNodeLocator() const {
+		return _node_locator;
+	}
+
 	const std::map<std::string, std::string> & getMap2wayLinks() const {
 		return _map_2way_links;
 	}
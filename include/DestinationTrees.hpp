@@ -0,0 +1,132 @@
+/****************************************************************
+ * DESTINATIONTREES.HPP
+ *
+ * This file contains the shortest path trees rooted at the most
+ * popular destinations of the simulation.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file DestinationTrees.hpp
+    \brief Next-hop tables towards high-demand destinations.
+ */
+
+#ifndef DESTINATIONTREES_HPP_
+#define DESTINATIONTREES_HPP_
+
+#include <map>
+#include <vector>
+#include <string>
+#include <boost/mpi.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "Network.hpp"
+
+//! Shortest path trees rooted at high-demand destinations.
+/*!
+  A few destinations (CBD, airport, large employment centres) attract a
+  large share of the trips. For each of them a reverse shortest path tree
+  is maintained, giving for every node the next link to take to reach the
+  destination. Agents heading to one of these destinations do not store
+  their path: their next link is looked up in the table at every node.
+
+  Every process holds every tree. When rebuilding, the trees are
+  distributed among the processes and then broadcast to the others.
+ */
+class DestinationTrees {
+
+private:
+
+  std::map<std::string, int>    _slots;      //!< slot of every hot destination (node id -> slot)
+  std::vector<int>              _dest_nodes; //!< dense node index of the destination of every slot
+  std::vector<std::vector<int>> _next_link;  //!< next link index of every node, for every slot (-1 if none)
+  std::vector<std::vector<float>> _dist;     //!< distance of every node to the destination, for the slots computed locally
+  std::vector<float>            _cost;       //!< link costs the trees were computed against
+
+  //! Compute the trees of a few slots against given link costs.
+  /*!
+    The OpenMP threads compute one tree each, or share the computation of
+    every tree (delta-stepping) when there are fewer trees than threads.
+
+    \param network the road network (index built)
+    \param slots the slots whose tree is computed
+    \param cost cost of every link, ordered by link index
+   */
+  void computeTrees(const Network& network, const std::vector<int>& slots, const std::vector<float>& cost);
+
+public:
+
+  //! Constructor.
+  DestinationTrees() {};
+
+  //! Destructor.
+  ~DestinationTrees() {};
+
+  //! Select the hot destinations given the number of trips ending at every node.
+  /*!
+    Destinations are ranked by number of trips and at most max_dest of them
+    are kept, provided they attract at least min_share of all the trips.
+
+    \param network the road network
+    \param n_trips number of trips ending at every node (dense node index)
+    \param max_dest maximum number of hot destinations
+    \param min_share minimum share of the trips a hot destination must attract
+   */
+  void selectDestinations(const Network& network, const std::vector<unsigned int>& n_trips,
+		                  unsigned int max_dest, float min_share);
+
+  //! Rebuild every tree against the given link costs.
+  /*!
+    Trees are computed by the process of rank (slot % size), its trees
+    being shared among its OpenMP threads, and broadcast to every other
+    process. This is a collective operation.
+
+    \param network the road network
+    \param cost cost of every link, ordered by link index
+    \param comm the MPI communicator
+   */
+  void rebuild(const Network& network, const std::vector<float>& cost, boost::mpi::communicator& comm);
+
+  //! Update the trees after the cost of a few links changed.
+  /*!
+    Only the trees the change may affect are recomputed: for a link
+    becoming more expensive, the trees using it; for a link becoming
+    cheaper, the trees in which it now gives a shorter path from its
+    source node. This is a collective operation.
+
+    \param network the road network
+    \param links the index of the links whose cost changed
+    \param cost cost of every link, ordered by link index (only the changed links are read)
+    \param comm the MPI communicator
+    \return the number of trees recomputed
+   */
+  unsigned int updateLinks(const Network& network, const std::vector<int>& links, const std::vector<float>& cost,
+		                   boost::mpi::communicator& comm);
+
+  //! Return the number of hot destinations.
+  unsigned int size() const {
+    return (unsigned int)_dest_nodes.size();
+  }
+
+  //! Check whether a node is a hot destination.
+  /*!
+    \param nodeId a node id
+    \return true if a tree is maintained for the node
+   */
+  bool isHot(const std::string& nodeId) const {
+    return _slots.count(nodeId) == 1;
+  }
+
+  //! Return the next link to take from a node to reach a hot destination.
+  /*!
+    \param destId the hot destination node id
+    \param nodeIndex the current node index
+    \return a link index, or -1 if the node is the destination or cannot reach it
+   */
+  int nextLink(const std::string& destId, int nodeIndex) const {
+    return _next_link[_slots.at(destId)][nodeIndex];
+  }
+
+};
+
+#endif /* DESTINATIONTREES_HPP_ */
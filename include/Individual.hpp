@@ -69,12 +69,14 @@ struct IndividualPackage {
 	float              cur_trip_duration_theo; //!< current theoretical trip duration.
 	int                n_path_performed;       //!< current number of path already performed (in the range [1, Trip.size()]).
 	int                n_link_in_path;         //!< number of links already traveled in the current path.
+	bool               on_dest_tree;           //!< indicates whether the agent follows a destination tree instead of its path.
+	float              fitness;                //!< fitness of the trips performed (negative if none).
 
 	//! Constructor.
 	IndividualPackage();
 	IndividualPackage(int aId, int aInitProc, int aAgentType, int aCurProc, std::vector<Trip> aTrips, float aX, float aY, float aRemainingTime,
 			Strategy aStrategy, std::vector<std::string> aPath, bool aEnRoute, bool aAtNode, std::string aCurLink, int aSize, float aCurTripDurationTheo,
-			int aNPathPerformed, int aNLinkInPath);
+			int aNPathPerformed, int aNLinkInPath, bool aOnDestTree, float aFitness);
 
 	//! Serializing procedure of the package.
 	/*!
@@ -101,6 +103,8 @@ struct IndividualPackage {
 		ar & cur_trip_duration_theo;
 		ar & n_path_performed;
 		ar & n_link_in_path;
+		ar & on_dest_tree;
+		ar & fitness;
 
 	}
 
@@ -145,6 +149,8 @@ private :
 	float             _cur_trip_duration_theo; //!< Current theoretical trip duration.
 	int               _n_path_performed;       //!< Current number of path already performed by the agent (in the range [1, number of trips]).
 	int               _n_link_in_path;         //!< Number of links already traveled in the current path.
+	bool              _on_dest_tree;           //!< Indicates whether the agent follows the destination tree of its current destination instead of its path.
+	float             _fitness;                //!< Fitness of the trips performed, theoretical over actual duration (negative if none).
 
 public :
 
@@ -156,7 +162,7 @@ public :
 	Individual( repast::AgentId id, std::vector<Trip> trips, float x, float y,
 		    	float remaining_time, Strategy strat, std::vector<std::string> path, bool en_route,
 			    bool at_node, std::string cur_link, int size, float cur_trip_duration_theo,
-				int n_path_performed, int n_link_in_path);
+				int n_path_performed, int n_link_in_path, bool on_dest_tree, float fitness);
 
 	//! Constructor.
 	Individual( repast::AgentId id, std::vector<Trip> trips, int size = 1 );
@@ -300,6 +306,27 @@ public :
 		_n_path_performed = nPathPerformed;
 	}
 
+	bool isOnDestTree() const {
+		return _on_dest_tree;
+	}
+
+	void setOnDestTree(bool onDestTree) {
+		_on_dest_tree = onDestTree;
+	}
+
+	float getFitness() const {
+		return _fitness;
+	}
+
+	void setFitness(float fitness) {
+		_fitness = fitness;
+	}
+
+	//! Add the fitness of a trip just performed, averaged with the previous ones.
+	void addTripFitness(float fitness) {
+		_fitness = _fitness < 0.0f ? fitness : ( _fitness + fitness ) * 0.5f;
+	}
+
 	//! Printing the agents characteristics.
 	void print();
 
@@ -315,14 +342,24 @@ public :
 	 */
 	std::string getNextLinkAndRemove();
 
+	//! Moving the agent to a link given by a destination tree.
+	/*!
+	  \param linkId the next link used by the agent
+	 */
+	void takeLink( const std::string& linkId );
+
 	bool isRerouting( Network & network, float simulation_time );
 
 	//! Setting the next trip of the individual.
 	/*!
 	  \network the road network on which the agent will undertake its trip
 	  \param time the number of seconds the agents have to wait until it starts its next trip
+	  \param use_dest_tree if true the agent follows the destination tree and no path is stored
+
+	  Only the imported path of the trip is stored, any other path being
+	  computed by the model (see Model::endTrips).
 	 */
-	void setNextTrip( Network& network, float time );
+	void setNextTrip( Network& network, float time, bool use_dest_tree = false );
 
 	//! Decreasing the agent's remaining time before its next event.
 	/*!
@@ -0,0 +1,76 @@
+/****************************************************************
+ * LINKCOSTSNAPSHOT.HPP
+ *
+ * This file contains the double-buffered snapshots of the links
+ * cost, written by the simulation and read by the routers.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file LinkCostSnapshot.hpp
+    \brief Immutable snapshots of the links cost, swapped without locks (RCU).
+ */
+
+#ifndef LINKCOSTSNAPSHOT_HPP_
+#define LINKCOSTSNAPSHOT_HPP_
+
+#include <memory>
+#include <vector>
+
+//! Snapshots of the cost of every link, read by the routers without locks.
+/*!
+  The number of agents of the links changes all along a step, so that a
+  router reading timeOnLink() while the simulation moves the agents would
+  see the links in a torn state. The simulation instead writes the cost
+  of every link in a back buffer and publishes it at once (end of a tick
+  or of a routing epoch); the routers acquire the last published snapshot,
+  which never changes while they hold it.
+
+  Publishing swaps the snapshot pointer atomically (read-copy-update): the
+  routers holding the previous snapshot keep it alive (shared pointer),
+  and its buffer is only reused for the next writing once they all
+  released it, a new buffer being allocated otherwise. A single thread
+  writes and publishes, any number of threads read.
+ */
+class LinkCostSnapshot {
+
+public:
+
+  typedef std::shared_ptr<const std::vector<float>> Snapshot;
+
+private:
+
+  std::shared_ptr<std::vector<float>> _buffers[2];  //!< the published buffer and the back buffer
+  int                                 _back;        //!< index of the back buffer
+  Snapshot                            _published;   //!< last published snapshot (accessed atomically)
+  unsigned long                       _version;     //!< number of snapshots published
+
+public:
+
+  //! Constructor.
+  LinkCostSnapshot();
+
+  //! Destructor.
+  ~LinkCostSnapshot() {};
+
+  //! Return the back buffer, to be written by the simulation before publishing it.
+  /*!
+    The buffer holds the cost of the snapshot published before the last
+    one, copied to a new buffer if a router still reads it.
+   */
+  std::vector<float>& write();
+
+  //! Publish the back buffer as the snapshot read by the routers.
+  void publish();
+
+  //! Return the last published snapshot (empty before the first publication).
+  Snapshot read() const;
+
+  //! Return the number of snapshots published.
+  unsigned long getVersion() const {
+    return _version;
+  }
+
+};
+
+#endif /* LINKCOSTSNAPSHOT_HPP_ */
@@ -0,0 +1,117 @@
+/****************************************************************
+ * LINKTIMETABLE.HPP
+ *
+ * This file contains the table of the congested travel time of
+ * every link, refreshed once per routing epoch from the links
+ * owned by every process.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file LinkTimeTable.hpp
+    \brief Global congested travel times, exchanged as quantised deltas.
+ */
+
+#ifndef LINKTIMETABLE_HPP_
+#define LINKTIMETABLE_HPP_
+
+#include <vector>
+#include <cstdint>
+#include <boost/mpi.hpp>
+#include <boost/serialization/vector.hpp>
+
+//! Congested travel time of every link, identical on every process.
+/*!
+  A process only knows the load of the links it owns (the links starting
+  at its nodes with the spatial decomposition, a share of the links with
+  the agents decomposition). Once per routing epoch, every process
+  publishes the travel time of its links and the table is gathered on
+  every process, so that the routers of any process read the same
+  congested view of the whole network.
+
+  The time of a link is kept as its congestion factor (time over free
+  flow time, minus one) quantised in steps of a given width on 16 bits: a
+  free flowing link is 0 and keeps its exact free flow time, whatever its
+  changes by network events. Only the factors changed since the previous
+  epoch are sent, packed in a byte buffer as the difference to the index
+  of the previous changed link (varint) followed by the factor, so that
+  the exchange costs 3 to 4 bytes per changed link on most networks.
+ */
+class LinkTimeTable {
+
+private:
+
+  float                  _step;       //!< width of the steps of the quantised congestion factors
+  std::vector<int>       _owned;      //!< index of the links published by the process, in increasing order
+  std::vector<uint16_t>  _factor;     //!< quantised congestion factor of every link, ordered by link index
+  unsigned long          _n_sent;     //!< number of factors sent by the process since the beginning
+  std::vector<int>       _changed;    //!< index of the links whose factor changed at the last update
+  unsigned int           _n_epochs;   //!< number of updates of the table
+
+  //! Return the quantised congestion factor of a link.
+  uint16_t quantise(float time, float free_flow_time) const;
+
+public:
+
+  //! Constructor.
+  LinkTimeTable() : _step(0.01f), _n_sent(0), _n_epochs(0) {};
+
+  //! Destructor.
+  ~LinkTimeTable() {};
+
+  //! Initialise the table with every link free flowing.
+  /*!
+    \param n_links the number of links of the network index
+    \param owned the index of the links published by the process (each link by exactly one process)
+    \param step the width of the steps of the congestion factors (e.g. 0.01 for 1% of the free flow time)
+   */
+  void build(int n_links, const std::vector<int>& owned, float step);
+
+  //! Check whether the table is in use.
+  bool isBuilt() const {
+    return _factor.empty() == false;
+  }
+
+  //! Publish the time of the links of the process and gather the changes of every process.
+  /*!
+    This is a collective operation.
+
+    \param free_flow the free flow time of every link, ordered by link index
+    \param times the current time of every link, ordered by link index (only the links of the process are read)
+    \param comm the MPI communicator
+    \return the number of links whose time changed on every process
+   */
+  unsigned int update(const std::vector<float>& free_flow, const std::vector<float>& times,
+		              boost::mpi::communicator& comm);
+
+  //! Return the time of a link as of the last update.
+  float getTime(int link_index, float free_flow_time) const {
+    return free_flow_time * ( 1.0f + _factor[link_index] * _step );
+  }
+
+  //! Write the time of every link as of the last update, ordered by link index.
+  void getTimes(const std::vector<float>& free_flow, std::vector<float>& times) const;
+
+  //! Return the number of links whose time changed at the last update.
+  unsigned int getNChanged() const {
+    return (unsigned int)_changed.size();
+  }
+
+  //! Return the index of the links whose time changed at the last update, identical on every process.
+  const std::vector<int>& getChanged() const {
+    return _changed;
+  }
+
+  //! Return the number of updates of the table.
+  unsigned int getNEpochs() const {
+    return _n_epochs;
+  }
+
+  //! Return the number of factors sent by the process since the beginning.
+  unsigned long getNSent() const {
+    return _n_sent;
+  }
+
+};
+
+#endif /* LINKTIMETABLE_HPP_ */
@@ -17,6 +17,15 @@
 
 #include "Individual.hpp"
 #include "Data.hpp"
+#include "DestinationTrees.hpp"
+#include "PartitionOverlay.hpp"
+#include "RouteTasks.hpp"
+#include "RouteCache.hpp"
+#include "LinkTimeTable.hpp"
+#include "LinkCostSnapshot.hpp"
+#include "PositionsWriter.hpp"
+#include "RouteLog.hpp"
+#include "PerfCounter.hpp"
 #include "tinyxml2.hpp"
 #include "FiboHeap.hpp"
 
@@ -37,7 +46,10 @@
 #include <stdexcept>
 #include <cmath>
 #include <vector>
+#include <set>
+#include <limits>
 #include <iomanip>
+#include <chrono>
 #include <boost/serialization/access.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/mpi.hpp>
@@ -50,6 +62,17 @@
 
 const int MODEL_AGENT_IND_TYPE = 0;     //!< constant for the individual agent type
 
+//! Distribution of the agents among the processes.
+enum class Decomposition : int { SPATIAL = 0,   //!< agents belong to the process owning their current node and migrate
+	                             AGENTS  = 1 }; //!< agents are given once to a process and never migrate
+
+//! Change of a link at a given time of the simulation (incident, lane closure, ...).
+struct NetworkEvent {
+  std::string link;       //!< original link id
+  std::string attribute;  //!< changed attribute: capacity or freespeed
+  float       value;      //!< new value of the attribute, in the units of the network file
+};
+
 //! Model class.
 /*!
   This class contains the scheduler and is responsible for data aggregation.
@@ -76,12 +99,199 @@ class Model {
   map<std::string, vector<int> >   _links_load_over_time;            //!< number of agents on each link per unit of time (defined by user)
   map<std::string, vector<int> >   _links_state_snapshot;            //!< number of agents on each link at a given point in time
   vector<float>             _trips_starting_time;             //!< trips starting time
-  map<std::string, int>     _map_node_process;                //!< map containing identifying the process of every node
+  map<std::string, int>     _map_node_process;                //!< map containing identifying the process of every node (local nodes only if sharded)
+  std::set<std::string>     _arrived_destinations;            //!< trips destinations of the agents migrated during the step (sharded network)
   map<repast::AgentId, int> _map_agents_to_move_process;      //!< map containing the agents id to be moved and their destination process
-  map<int, float>           _map_agent_fitness;                //!< map containing the final fitness of the agent after the trip is over
+  std::vector<Individual*>  _due_entries;                     //!< agents entering their next link during the step
+  std::vector<Individual*>  _due_arrivals;                    //!< agents reaching the end node of their link during the step
+  std::vector<Individual*>  _due_trip_ends;                   //!< agents reaching the destination of their trip during the step
+  bool                      _pin_threads;                     //!< OpenMP threads pinned to the cores and network index placed on their nodes
+  std::vector<Individual*>  _agents_order;                    //!< local agents in the order they are stepped (reordering enabled)
+  unsigned int              _reorder_interval;                //!< number of steps between two reorderings of the agents by link (0 = context order)
+  std::set<Individual*>     _agents_left;                     //!< agents removed or migrated since the last repair of the order
+  std::vector<Individual*>  _agents_arrived;                  //!< agents migrated to the process since the last repair of the order
+  bool                      _step_stats;                      //!< measure the locality of the agents updates
+  PerfCounter               _step_misses;                     //!< cache misses of the agents updates
+  unsigned long long        _n_agents_stepped;                //!< number of agents updates measured
+  unsigned long long        _n_link_switches;                 //!< number of consecutive updated agents on different links
+  std::vector<int>          _finished_agents;                 //!< index of the agents which left the simulation
+  std::vector<float>        _finished_fitness;                //!< final fitness of the agents which left the simulation
 
   std::map<std::string, std::map<std::string, std::vector<std::string>>> _look_up_paths; //!< Look up table for path
 
+  DestinationTrees          _dest_trees;                      //!< shortest path trees towards the hot destinations
+  unsigned int              _dest_trees_interval;             //!< time interval between two rebuilds of the destination trees (0 = never)
+
+  PartitionOverlay          _overlay;                         //!< overlay graph of the partitions (sharded network only)
+
+  Decomposition             _decomposition;                   //!< distribution of the agents among the processes
+  std::vector<unsigned int> _n_trips_proc;                    //!< number of trips of the agents given to every process (agents decomposition)
+  std::map<int, int>        _link_deltas;                     //!< change of the number of agents of every link during the step (agents decomposition)
+
+  RouteTasks                _route_tasks;                     //!< routing requests computed by any process
+  unsigned int              _route_tasks_interval;            //!< time interval between two runs of the routing requests (0 = routing done locally)
+  bool                      _use_route_cache;                 //!< routing requests answered by the distributed paths cache instead of work stealing
+  RouteCache                _route_cache;                     //!< paths cache distributed among the processes
+
+  LinkTimeTable             _link_times;                      //!< congested time of every link, gathered once per routing epoch
+  LinkCostSnapshot          _link_costs;                      //!< time of every link as of the last epoch, minimised by the routers
+  unsigned int              _link_times_interval;             //!< time interval between two routing epochs (0 = routing at free flow)
+
+  float                     _start_time;                      //!< beginning of the simulated time window (s)
+  float                     _end_time;                        //!< end of the simulated time window (s)
+  std::set<int>             _warm_agents;                     //!< agents of the warm start file, whose trips of the window are appended by the trips loaders
+
+  std::map<float, std::vector<NetworkEvent>> _network_events; //!< link changes still to apply, by time
+  std::unordered_map<std::string, std::set<std::pair<std::string, std::string>>> _cached_paths_by_link; //!< (origin, destination) of the paths of the look up table using every link
+
+  PositionsWriter           _positions;                       //!< stream of the vehicles positions
+  unsigned int              _positions_interval;              //!< time interval between two snapshots of the vehicles positions (0 = none)
+  std::unordered_map<std::string, int> _positions_links;      //!< index of every link of the input network in the positions links table
+  RouteLog                  _route_log;                       //!< log of the routing requests (closed = none)
+
+  //! Check if a trip starting at a given time is simulated.
+  bool isInTimeWindow(float time) const {
+    return time >= _start_time && time < _end_time;
+  }
+
+  //! Check if the simulation stops at the end of a time window.
+  bool hasTimeWindowEnd() const {
+    return _end_time < std::numeric_limits<float>::max();
+  }
+
+  //! Compute a path, only up to the end of the local partition if the network is sharded.
+  /*!
+    \param source_id the source node id
+    \param dest_id the destination node id
+    \param site the call site, for the log of the routing requests
+    \param link_id_to_avoid a link to avoid if possible (none if empty)
+    \return the links of the path, in reverse order
+   */
+  std::vector<std::string> computePath(const std::string& source_id, const std::string& dest_id, RouteSite site,
+		                               const std::string& link_id_to_avoid = "");
+
+  //! Check if an agent starting its day at a node belongs to the local process.
+  /*!
+    With the spatial decomposition, the agent belongs to the process owning
+    the node. Otherwise it is given to the process having the fewest trips
+    so far, every process reading the agents in the same order and taking
+    the same decision.
+
+    \param origin_id the first node of the agent
+    \param n_trips the number of trips of the agent
+    \return true if the agent belongs to the local process
+   */
+  bool isLocalAgent(const std::string& origin_id, unsigned int n_trips);
+
+  //! Check if a trip can be routed, i.e. both its nodes exist and its destination is reachable.
+  /*!
+    With a sharded network, only the existence of the nodes is checked.
+
+    \param origin_id the origin node of the trip
+    \param dest_id the destination node of the trip
+    \return true if a path exists between the nodes
+   */
+  bool isRoutable(const std::string& origin_id, const std::string& dest_id) const;
+
+  //! Add (delta = 1) or remove (delta = -1) an agent on a link.
+  void updateLinkLoad(const std::string& linkId, int delta);
+
+  //! Apply the changes of the links load made by the other processes during the step (agents decomposition).
+  void exchangeLinkLoads();
+
+  //! Sum the links records of every process on process 0 (agents decomposition).
+  void reduceLinksRecords();
+
+  //! Publish a routing request, computed by any process (work stealing) or by the owner of the pair (distributed cache).
+  void publishRoute(const std::string& source_id, const std::string& dest_id, int deliver_to);
+
+  //! Check whether a path is known locally (look up table or near cache).
+  bool hasPath(const std::string& source_id, const std::string& dest_id);
+
+  //! Return a path from the look up table, computing it if not found (site: call site of the request, logged when found too).
+  std::vector<std::string> lookUpPath(const std::string& source_id, const std::string& dest_id, RouteSite site);
+
+  //! Record the links used by a path of the look up table, while network events remain or with a routing epoch.
+  void indexCachedPath(const std::string& source_id, const std::string& dest_id);
+
+  //! Invalidate the routing state depending on links whose cost changed.
+  /*!
+    Only the paths of the look up table using the links are removed, and
+    only the destination trees and the partition overlay shortcuts
+    affected are recomputed. This is a collective operation.
+
+    \param links the id of the links of the network whose cost changed
+   */
+  void invalidateRouting(const std::set<std::string>& links);
+
+  //! Return the current travel time of every link, ordered by link index (global load).
+  /*!
+    With a routing epoch, the times of the global table are returned
+    instead, without communication.
+   */
+  std::vector<float> getCurrentLinksTime();
+
+  //! Return the snapshot of the links cost minimised by the routers, NULL for the free flow times.
+  /*!
+    The snapshot never changes while held, whatever the epochs published
+    meanwhile.
+   */
+  LinkCostSnapshot::Snapshot getRoutingCost() const {
+    return _link_times.isBuilt() == true ? _link_costs.read() : LinkCostSnapshot::Snapshot();
+  }
+
+  //! Return the node at which an agent stopped at a node is.
+  std::string getCurNodeId(Individual * agent);
+
+  //! Return the next link of an agent at a node and move it to this link.
+  /*!
+    \param agent an agent stopped at a node
+    \return the id of the next link taken by the agent, empty if no path leads to its destination
+   */
+  std::string moveToNextLink(Individual * agent);
+
+  //! Sort the local agents by current link, the agents at a node or waiting for their trip by remaining time.
+  /*!
+    The agents of a link being stepped one after the other, the state of
+    the link (and of the neighbouring links, close in the links index) is
+    read from cache instead of memory.
+   */
+  void reorderAgents();
+
+  //! Remove the agents which left the process from the order, and add the ones which migrated to it.
+  void repairAgentsOrder();
+
+  //! Move the agents at a node to their next link.
+  /*!
+    The next links are determined first (paths, strategies), then the
+    agents enter them in turn, every agent traveling its link at the time
+    given by the agents entered before it. The agents without a path to
+    their destination (sharded network only) are removed with a warning.
+
+    \param due the agents at a node whose waiting time is over
+    \param cur_time_interval the current interval of the links load records
+   */
+  void enterLinks(const std::vector<Individual*>& due, int cur_time_interval);
+
+  //! Move the agents reaching the end of their link to its end node.
+  /*!
+    \param due the agents reaching the end of their link, not the destination of their trip
+   */
+  void arriveAtNodes(const std::vector<Individual*>& due);
+
+  //! Complete the trips of the agents reaching their destination, starting their next trip or removing them.
+  /*!
+    \param due the agents reaching the destination of their trip
+   */
+  void endTrips(const std::vector<Individual*>& due);
+
+  //! Check if an agent reaching the end of its current link still has links to travel.
+  /*!
+    \param agent an agent on a link
+    \return true if the end of the link is not the destination of the current trip
+   */
+  bool hasLinksLeft(Individual * agent);
+
  public :
 
   repast::SharedContext<Individual>* agents;               //!< Shared context containing the individual agents of the simulation
@@ -97,15 +307,89 @@ class Model {
   //! Destructor.
   ~Model();
   
+  //! Agents already on the road at the beginning of the time window.
+  /*!
+    The warm start file (file.warm_start) is the one written at the end of
+    a previous time window (see writeWarmStart), one line per agent on a
+    link: id, link, remaining time on the link and its trips (origin,
+    destination, starting time), the current one first. The current trip
+    is resumed from the end of the link. The trips of these agents starting
+    in the time window are then read from the trips file and appended to
+    the ones of the warm start (see appendWarmTrips), the file only holding
+    the trips of the previous window.
+
+    \return the number of trips of the local agents
+   */
+  unsigned int init_warm_start();
+
+  //! Return the local agent of the warm start with a given index, NULL if none (not warm-started or on another process).
+  Individual* getWarmAgent(int id);
+
+  //! Append the trips of the time window read from the trips file to the local agent of the warm start with a given index.
+  void appendWarmTrips(int id, const std::vector<Trip>& trips);
+
   //! Model agents initialization (transims input format).
   unsigned int init_transims();
 
   //! Model agents initialization (MATSim input format).
   unsigned int init_matsim();
 
+  //! Read the route of a MATSim leg as the path of a trip.
+  /*!
+    The route is either a sequence of links (type="links"), starting with the
+    link of the origin activity, or a sequence of nodes converted to links.
+    The path is only set if it is valid, i.e. it goes from the trip origin
+    to its destination through links of the network.
+
+    \param ele_leg the leg of the trip (NULL if none)
+    \param trip the trip
+    \return false if the leg has a route which is not valid
+   */
+  bool read_matsim_route(tinyxml2::XMLElement * ele_leg, Trip& trip);
+
+  //! Set the node of the MATSim activities given by a link or by coordinates only.
+  /*!
+    An activity given by a link is located at the end node of the link, an
+    activity given by coordinates at the nearest node. The node is added to
+    the activity as its node_id attribute. An activity with an unknown link
+    and no coordinates gets no node: its trips are rejected as unroutable.
+    With a sharded network, the nodes of the network file are indexed for
+    the time of the snapping only.
+
+    \param doc the MATSim plans
+   */
+  void snap_matsim_activities(tinyxml2::XMLDocument& doc);
+
   //! Model agents strategies initialization.
   void init_agents_strategies();
 
+  //! Network events initialization.
+  /*!
+    The events file (file.network_events) gives one change of a link per
+    line: time, original link id, attribute (capacity or freespeed) and
+    its new value. Events before the time window are applied before the
+    first step.
+   */
+  void init_network_events();
+
+  //! Global table of the congested link times initialization.
+  /*!
+    With a routing epoch (par.link_times_interval), every process publishes
+    the times of the links starting at its nodes (spatial decomposition)
+    or of every n-th link (agents decomposition), and the paths minimise
+    the times of the table instead of the free flow times.
+   */
+  void init_link_times();
+
+  //! Contraction of the chains of degree-2 nodes, keeping the trips origins and destinations.
+  void contract_network();
+
+  //! Hot destinations selection and initial computation of their trees.
+  void init_destination_trees();
+
+  //! Overlay graph construction when every process only stores its partition of the network.
+  void init_overlay();
+
   //! Agents initial path computation.
   void compute_initial_paths();
 
@@ -178,12 +462,33 @@ class Model {
   //! Check if the simulation should continue or stop.
   void checkStop();
 
+  //! Compute the routing requests published by every process.
+  void runRouteTasks();
+
+  //! Rebuild the destination trees against the current link travel times.
+  void updateDestinationTrees();
+
+  //! Start a routing epoch: gather the congested times of the links of every process.
+  void updateLinkTimes();
+
+  //! Apply the next network events and invalidate the routing state depending on the changed links.
+  void applyNetworkEvents();
+
+  //! Adding the positions of the local vehicles on the road to the positions stream.
+  void writePositions();
+
+  //! Writing the locality measures of the agents updates (cache misses and links switches).
+  void writeStepStats();
+
   //! Writing the link states (snapshot and aggregate) in a file.
   void writeLinksState();
 
   //! Writing the trips starting times in a file.
   void writeTripsStartingTimes();
 
+  //! Writing the agents on the road at the end of the time window, to warm start the next one.
+  void writeWarmStart();
+
   //! Writing final agents fitness
   void writeAgentFitness();
 
@@ -193,6 +498,17 @@ class Model {
   //! Constructing the map of processes' nodes
   void constructMapNodeProcess();
 
+  //! Return the process owning a node.
+  /*!
+    A sharded network gives the owner of its stored nodes. The owner of
+    another node is only known if it is a destination completed by the
+    overlay, the local process being returned otherwise.
+
+    \param node_id a node id
+    \return the process owning the node
+   */
+  int getNodeProcess(const std::string& node_id);
+
   //! Check if a (x,y) coordinates belongs to the local continuous space.
   /*!
     \param x a x coordinate
@@ -22,11 +22,13 @@
 #include <utility>
 #include <sstream>
 #include <set>
+#include <unordered_map>
 #include <algorithm>
 #include <string>
 #include <math.h>
 #include "Random.hpp"
 #include "FiboHeap.hpp"
+#include "Placement.hpp"
 #include <boost/math/special_functions/pow.hpp>
 
 //! A node class.
@@ -404,8 +406,20 @@ public:
   //! Compute the required time for an agent to go trough the link.
   float timeOnLink() const;
 
+  //! Compute the required time to go trough the link for a given number of agents on it.
+  /*!
+    \param n_agents a number of agents on the link
+    \return the travel time on the link
+   */
+  float timeOnLink(unsigned int n_agents) const;
+
 };
 
+//! Ordering of the nodes dense index.
+enum class NodeOrder : int { ID = 0,        //!< order of the nodes id
+	                         HILBERT = 1,   //!< position along a Hilbert curve over the nodes real coordinates
+	                         RCM = 2 };     //!< reverse Cuthill-McKee order of the (undirected) graph
+
 //! A Network class.
 /*!
   This class implements a network consisting of a set of nodes and links.
@@ -425,10 +439,65 @@ private:
 
   std::map<long, std::map<long, std::vector<long>>> _look_up_paths; //!< Look up table for path
 
+  NodeOrder                            _node_order;               //!< Ordering of the dense node index
+  std::vector<std::string>             _node_ids;                 //!< Nodes id ordered by dense node index
+  std::vector<std::string>             _link_ids;                 //!< Links id ordered by dense link index
+  std::unordered_map<std::string, int> _node_index;               //!< Dense index of every node
+  std::unordered_map<std::string, int> _link_index;               //!< Dense index of every link
+  PlacedVector<int>                    _link_start;               //!< Source node index of every link
+  PlacedVector<int>                    _link_end;                 //!< Sink node index of every link
+  PlacedVector<int>                    _out_first;                //!< Offset of the first outgoing link of every node in _out_links
+  PlacedVector<int>                    _out_links;                //!< Outgoing links index, grouped by source node
+  PlacedVector<int>                    _in_first;                 //!< Offset of the first incoming link of every node in _in_links
+  PlacedVector<int>                    _in_links;                 //!< Incoming links index, grouped by sink node
+  std::unordered_map<long, int>        _link_between;             //!< Link index of every (source node index, sink node index) pair
+  std::vector<int>                     _component;                //!< Strongly connected component of every node (by dense node index)
+  std::vector<int>                     _component_size;           //!< Number of nodes of every component
+  std::vector<int>                     _comp_first;               //!< Offset of the first successor of every component in _comp_succ
+  std::vector<int>                     _comp_succ;                //!< Successors of every component in the condensed graph
+
+  std::map<std::string, std::vector<std::string>> _chains;        //!< Original links of every contracted chain (super link id -> links id)
+  std::map<std::string, Link>                      _chain_links;   //!< Original links removed by the chains contraction
+  std::unordered_map<std::string, std::string>     _chain_of;      //!< Super link of every original link removed by the chains contraction
+
+  int                                  _partition;                //!< Process whose partition is stored (-1 if the whole network is stored)
+  double                               _curve_min_x;              //!< minimum x coordinate of the Hilbert curve dividing a sharded network
+  double                               _curve_min_y;              //!< minimum y coordinate of the Hilbert curve dividing a sharded network
+  double                               _curve_scale;              //!< curve cells per coordinate unit
+  std::vector<unsigned long>           _owner_first_key;          //!< first Hilbert key of the range of every process (sharded network)
+
+  //! Compute the strongly connected components of the indexed network (Tarjan).
+  /*!
+    Components are numbered in reverse topological order: a component
+    only reaches components with a lower number.
+   */
+  void computeComponents();
+
+  //! Return the nodes (temporary index) ordered along a Hilbert curve.
+  std::vector<int> hilbertOrder(const std::vector<std::string>& ids_nodes) const;
+
+  //! Return the position along a Hilbert curve of 2^16 x 2^16 cells of a real coordinate.
+  static unsigned long hilbertKey(double x, double y, double min_x, double min_y, double scale);
+
+  //! Return the number of Hilbert curve cells per coordinate unit of a bounding box.
+  static double hilbertScale(double min_x, double max_x, double min_y, double max_y);
+
+  //! Return the nodes (temporary index) in reverse Cuthill-McKee order.
+  std::vector<int> rcmOrder(const std::vector<std::string>& ids_nodes, const std::unordered_map<std::string, int>& tmp_index) const;
+
+  //! Set the predecessor of every node to the lowest index link achieving its distance.
+  void settlePredecessors(int source_index, const std::vector<float>& cost, const std::vector<float>& dist, std::vector<int>& pred) const;
+
+  //! Set the next link of every node to the lowest index link achieving its distance to the destination.
+  void settleNextLinks(int dest_index, const std::vector<float>& cost, const std::vector<float>& dist, std::vector<int>& next_link) const;
+
+  //! Compute the distances from a root node by delta-stepping, on the reversed graph (distances to the root) if reverse.
+  void deltaSteppingDistances(int root_index, const std::vector<float>& cost, std::vector<float>& dist, float delta, bool reverse) const;
+
 public:
 
   //! Constructor.
-  Network() {
+  Network() : _node_order(NodeOrder::ID), _partition(-1), _curve_min_x(0.0), _curve_min_y(0.0), _curve_scale(1.0) {
 
     min_x = std::numeric_limits<double>::max();
     min_y = std::numeric_limits<double>::max();
@@ -517,6 +586,323 @@ public:
 
   std::vector<std::string> computePathAStar(std::string source_id, std::string dest_id, bool fastest = true);
 
+  //! Compute the path of least cost between two nodes given the cost of every link.
+  /*!
+    Dijkstra on the dense index, stopped once the destination is settled
+    (e.g. with the congested times of a LinkTimeTable). The path is given
+    in reverse order, as the one of computePath.
+
+    \param source_id source node
+    \param dest_id destination node
+    \param cost cost of every link, ordered by link index
+   */
+  std::vector<std::string> computePath(const std::string& source_id, const std::string& dest_id, const std::vector<float>& cost) const;
+
+  //! Build the dense indexing of the nodes and links.
+  /*!
+    Nodes are numbered from 0 following the order set by setNodeOrder,
+    and links are numbered by source node (then by id) so that the links
+    of a node are contiguous. The forward and backward adjacency of every
+    node is stored in compressed arrays. Must be called once the network
+    is fully loaded. Ids are unchanged, only the internal numbering is.
+   */
+  void buildIndex();
+
+  //! Place the arrays of the dense index on the NUMA nodes of the threads reading them.
+  /*!
+    The pages of every array are interleaved over the nodes of the (pinned)
+    OpenMP threads, see Placement::interleave: a shortest path search, run
+    by any thread, reads the whole index in the order of the graph, so
+    that a placement by static chunks would not bring the reads closer to
+    their thread. The state of the links (their load) is kept in the Link
+    objects of the network, allocated one by one by the master thread, and
+    is not placed. Must be called again after buildIndex.
+
+    \return the number of pages of the outgoing links array on every NUMA node
+   */
+  std::string placeIndex();
+
+  //! Return the ordering of the dense node index.
+  NodeOrder getNodeOrder() const {
+    return _node_order;
+  }
+
+  //! Set the ordering of the dense node index (applied by the next buildIndex).
+  /*!
+    \param nodeOrder a nodes ordering
+   */
+  void setNodeOrder(NodeOrder nodeOrder) {
+    _node_order = nodeOrder;
+  }
+
+  //! Return the number of indexed nodes.
+  int getNNodesIndexed() const {
+    return (int)_node_ids.size();
+  }
+
+  //! Return the number of indexed links.
+  int getNLinksIndexed() const {
+    return (int)_link_ids.size();
+  }
+
+  //! Return the dense index of a node.
+  int getNodeIndex(const std::string& nodeId) const {
+    return _node_index.at(nodeId);
+  }
+
+  //! Return the dense index of a link.
+  int getLinkIndex(const std::string& linkId) const {
+    return _link_index.at(linkId);
+  }
+
+  //! Return the id of the node with a given dense index.
+  const std::string& getNodeIdByIndex(int nodeIndex) const {
+    return _node_ids[nodeIndex];
+  }
+
+  //! Return the id of the link with a given dense index.
+  const std::string& getLinkIdByIndex(int linkIndex) const {
+    return _link_ids[linkIndex];
+  }
+
+  //! Return the source node index of a link.
+  int getLinkStartIndex(int linkIndex) const {
+    return _link_start[linkIndex];
+  }
+
+  //! Return the sink node index of a link.
+  int getLinkEndIndex(int linkIndex) const {
+    return _link_end[linkIndex];
+  }
+
+  //! Return the link joining two nodes.
+  /*!
+    \param from_index dense index of the source node
+    \param to_index dense index of the sink node
+    \return the lowest index of the links from the source to the sink, -1 if none
+   */
+  int getLinkBetween(int from_index, int to_index) const {
+    auto it = _link_between.find( (long)from_index * (long)_node_ids.size() + to_index );
+    return it == _link_between.end() ? -1 : it->second;
+  }
+
+  //! Return the strongly connected component of a node.
+  int getComponent(const std::string& nodeId) const {
+    return _component[_node_index.at(nodeId)];
+  }
+
+  //! Return the number of strongly connected components.
+  int getNComponents() const {
+    return (int)_component_size.size();
+  }
+
+  //! Return the largest strongly connected component.
+  int getLargestComponent() const {
+    return (int)( std::max_element(_component_size.begin(), _component_size.end()) - _component_size.begin() );
+  }
+
+  //! Check whether a node can be reached from another one.
+  /*!
+    Answered in constant time when both nodes are in the same strongly
+    connected component, or when the destination component comes after
+    the source one in topological order. Otherwise the condensed graph is
+    searched. Always true with a sharded network (only the partition is known).
+
+    \param source_id the source node id
+    \param dest_id the destination node id
+    \return true if there is a path from the source to the destination
+   */
+  bool isReachable(const std::string& source_id, const std::string& dest_id) const;
+
+  //! Only keep the largest strongly connected component.
+  /*!
+    Nodes outside the component and links not joining two nodes of the
+    component are removed. The index must be built before and rebuilt
+    afterwards.
+
+    \return the number of nodes removed
+   */
+  unsigned int restrictToLargestComponent();
+
+  //! Check whether a node exists, a node not stored by a sharded network being assumed in another partition.
+  bool hasNode(const std::string& nodeId) const {
+    return _Nodes.count(nodeId) == 1 || _partition >= 0;
+  }
+
+  //! Check whether a path (links in reverse order) is a valid path between two nodes.
+  bool isValidPath(const std::vector<std::string>& path, const std::string& source_id, const std::string& dest_id) const;
+
+  //! Return the number of agents on every link, ordered by link index.
+  std::vector<unsigned int> getLinksNAgents() const;
+
+  //! Return the travel time of every link, ordered by link index.
+  /*!
+    \param n_agents number of agents on every link, ordered by link index (free flow times if empty)
+    \return the travel time of every link
+   */
+  std::vector<float> getLinksTime(const std::vector<unsigned int>& n_agents = std::vector<unsigned int>()) const;
+
+  //! Compute the shortest path tree rooted at a destination node.
+  /*!
+    Runs Dijkstra on the reversed graph from the destination. On return,
+    next_link[n] is the index of the first link of the shortest path from
+    node n to the destination, or -1 if n is the destination itself or
+    cannot reach it. Among links giving the same distance, the one with the
+    lowest index is kept.
+
+    \param dest_index dense index of the destination node
+    \param cost cost of every link, ordered by link index
+    \param next_link resulting next link of every node
+   */
+  void computeTreeToDestination(int dest_index, const std::vector<float>& cost, std::vector<int>& next_link) const;
+
+  //! Compute the shortest path tree rooted at a destination node, with the distances.
+  /*!
+    Same as above, dist[n] being in addition the cost of the shortest path
+    from node n to the destination (max float if it cannot reach it).
+   */
+  void computeTreeToDestination(int dest_index, const std::vector<float>& cost, std::vector<int>& next_link,
+		                        std::vector<float>& dist) const;
+
+  //! Compute the shortest path tree rooted at a source node (serial Dijkstra).
+  /*!
+    On return, dist[n] is the cost of the shortest path from the source to
+    node n (max float if unreachable) and pred[n] the index of the last link
+    of this path (-1 for the source and unreachable nodes). Among links giving
+    the same distance, the one with the lowest index is kept as predecessor.
+
+    \param source_index dense index of the source node
+    \param cost cost of every link, ordered by link index
+    \param dist resulting distance of every node
+    \param pred resulting predecessor link of every node
+   */
+  void computeTree(int source_index, const std::vector<float>& cost, std::vector<float>& dist, std::vector<int>& pred) const;
+
+  //! Compute the shortest path tree rooted at a source node (parallel delta-stepping).
+  /*!
+    Nodes are kept in buckets of width delta. Every bucket is settled in
+    phases relaxing light links (cost <= delta) and then heavy links, the
+    relaxations of a phase being processed by the OpenMP threads. The
+    resulting tree is identical to the one of computeTree.
+
+    \param source_index dense index of the source node
+    \param cost cost of every link, ordered by link index
+    \param dist resulting distance of every node
+    \param pred resulting predecessor link of every node
+    \param delta bucket width (if <= 0, deltaSteppingWidth(cost) is used)
+   */
+  void computeTreeDeltaStepping(int source_index, const std::vector<float>& cost, std::vector<float>& dist,
+		                        std::vector<int>& pred, float delta = 0.0f) const;
+
+  //! Compute the shortest path tree rooted at a destination node (parallel delta-stepping).
+  /*!
+    Delta-stepping on the reversed graph from the destination, the OpenMP
+    threads sharing the relaxations of every phase. The resulting tree and
+    distances are identical to the ones of computeTreeToDestination, so that
+    it is worth it when a few trees are computed at once only.
+
+    \param dest_index dense index of the destination node
+    \param cost cost of every link, ordered by link index
+    \param next_link resulting next link of every node
+    \param dist resulting distance of every node to the destination
+    \param delta bucket width (if <= 0, deltaSteppingWidth(cost) is used)
+   */
+  void computeTreeToDestinationDeltaStepping(int dest_index, const std::vector<float>& cost, std::vector<int>& next_link,
+		                                     std::vector<float>& dist, float delta = 0.0f) const;
+
+  //! Return a bucket width for delta-stepping given the links cost.
+  /*!
+    The width is the mean link cost times the mean out-degree, i.e. about
+    the cost of one hop over every outgoing link of a node, and never less
+    than the smallest positive link cost.
+
+    \param cost cost of every link, ordered by link index
+    \return a bucket width
+   */
+  float deltaSteppingWidth(const std::vector<float>& cost) const;
+
+  //! Contract the chains of degree-2 nodes into super links.
+  /*!
+    A node is a chain node if it is not protected and if every link
+    entering it can be continued by exactly one link leaving it towards
+    another neighbour, i.e. it has one way in and one way out, or two
+    neighbours connected in both directions. Every maximal sequence of
+    links going through chain nodes is replaced by a single super link:
+    - its length and free flow time are the sums of those of its links;
+    - its capacity is the smallest capacity of its links times their number,
+      so that agents spread over the chain face its bottleneck.
+
+    The chain nodes are removed from the network, and the original links
+    are kept to map the outputs back (see getOriginalLinks). The index
+    must be built before and rebuilt after the contraction.
+
+    \param protected_nodes nodes that must be kept (e.g. trips origins and destinations), by dense node index
+    \return the number of nodes removed
+   */
+  unsigned int contractChains(const std::vector<bool>& protected_nodes);
+
+  //! Check whether a link is a super link resulting from a chain contraction.
+  bool isChain(const std::string& linkId) const {
+    return _chains.count(linkId) == 1;
+  }
+
+  //! Return the original links of a link (itself if not a super link).
+  std::vector<std::string> getOriginalLinks(const std::string& linkId) const;
+
+  //! Map a path of original links onto the contracted network.
+  /*!
+    Every sequence of links of a contracted chain is replaced by its super
+    link, the other links being kept as they are.
+
+    \param path a path of original links (in reverse order)
+    \param contracted the same path on the contracted network (in reverse order)
+    \return false if the path enters or leaves a chain part-way
+   */
+  bool contractPath(const std::vector<std::string>& path, std::vector<std::string>& contracted) const;
+
+  //! Return an original link (contracted or not) given its id.
+  const Link& getOriginalLink(const std::string& linkId) const;
+
+  //! Check whether an original link (contracted or not) is stored.
+  bool hasOriginalLink(const std::string& linkId) const {
+    return _Links.count(linkId) == 1 || _chain_links.count(linkId) == 1;
+  }
+
+  //! Change the capacity and free flow time of an original link.
+  /*!
+    If the link was contracted, the super link containing it is updated
+    as well (see contractChains).
+
+    \param linkId an original link id (stored, see hasOriginalLink)
+    \param capacity the new capacity of the link
+    \param freeFlowTime the new free flow time of the link
+    \return the id of the link of the network whose cost changed (the link itself or its super link)
+   */
+  std::string changeLink(const std::string& linkId, float capacity, float freeFlowTime);
+
+  //! Return the original link on which an agent is located on a link.
+  /*!
+    The position along a super link is mapped to its original links
+    proportionally to their free flow time.
+
+    \param linkId a link id
+    \param progress fraction of the link already traveled (in [0,1])
+    \return the id of the original link
+   */
+  std::string getOriginalLinkAt(const std::string& linkId, float progress) const {
+    float link_progress;
+    return getOriginalLinkAt(linkId, progress, link_progress);
+  }
+
+  //! Return the original link on which an agent is located on a link, and the fraction of it already traveled.
+  /*!
+    \param linkId a link id
+    \param progress fraction of the link already traveled (in [0,1])
+    \param link_progress fraction of the original link already traveled (output)
+    \return the id of the original link
+   */
+  std::string getOriginalLinkAt(const std::string& linkId, float progress, float& link_progress) const;
+
   //! Compute the Euclidean distance between two nodes.
   /*
     \param source_id the first node id
@@ -592,8 +978,53 @@ public:
   //! Shuffle the nodes coordinates
   /*!
     The new nodes coordinates {x,y}_shuffle are randomly set in [min_{x,y},max_{x,y}]
+
+    Every process owns every n-th node, or with a sharded network the nodes
+    of its range along the Hilbert curve (see setPartition).
   */
-  void shuffleNodesCoordinates();  
+  void shuffleNodesCoordinates();
+
+  //! Set the partition of a process along the Hilbert curve, before its nodes are added.
+  /*!
+    Every process owns a contiguous range of the positions along a Hilbert
+    curve over the bounding box of the whole network, so that the owner of
+    any location is known from its coordinates only. The nodes added
+    afterwards are the ones of the partition and the boundary nodes of its
+    links (see Data::read_network_partition).
+
+    \param rank the process whose partition is stored
+    \param min_x minimum x coordinate of the whole network
+    \param max_x maximum x coordinate of the whole network
+    \param min_y minimum y coordinate of the whole network
+    \param max_y maximum y coordinate of the whole network
+    \param first_keys first curve position (see getCurveKey) of the range of every process, the first one being 0
+   */
+  void setPartition(int rank, double min_x, double max_x, double min_y, double max_y, const std::vector<unsigned long>& first_keys);
+
+  //! Return the position along the Hilbert curve of the partition of a real coordinate.
+  unsigned long getCurveKey(double x, double y) const {
+    return hilbertKey(x, y, _curve_min_x, _curve_min_y, _curve_scale);
+  }
+
+  //! Return the process owning a real coordinate with a sharded network, -1 otherwise.
+  int getOwnerAt(double x, double y) const;
+
+  //! Return the process owning a stored node, -1 if it is not stored.
+  /*!
+    The owner of the node of a sharded network is given by its position along
+    the Hilbert curve, otherwise by its shuffled x coordinate (see shuffleNodesCoordinates).
+   */
+  int getNodeOwner(const std::string& nodeId) const;
+
+  //! Return the process whose partition is stored, -1 if the whole network is stored.
+  int getPartition() const {
+    return _partition;
+  }
+
+  //! Check whether a node belongs to the stored partition (always true for the whole network).
+  bool isInPartition(const std::string& nodeId) const {
+    return _partition < 0 || getNodeOwner(nodeId) == _partition;
+  }
   
   //! Increment the number of agent on a given link.
   void incrementAgentOnLink(std::string aLinkId){
@@ -605,6 +1036,12 @@ public:
 	  _Links.at(aLinkId).decrementAgents();
   }
 
+  //! Change the number of agent on a given link by a given (possibly negative) number.
+  void addAgentsOnLink(const std::string& aLinkId, int nAgents){
+	  Link& lnk = _Links.at(aLinkId);
+	  lnk.setNAgents( (unsigned int)( (int)lnk.getNAgents() + nAgents ) );
+  }
+
 };
 
 #endif /* NETWORK_HPP_ */
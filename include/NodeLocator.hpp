@@ -0,0 +1,109 @@
+/****************************************************************
+ * NODELOCATOR.HPP
+ *
+ * This file contains the spatial index used to locate the nodes
+ * of the road network from coordinates or link ids.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file NodeLocator.hpp
+    \brief Spatial index of the network nodes (packed grid).
+ */
+
+#ifndef NODELOCATOR_HPP_
+#define NODELOCATOR_HPP_
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "Network.hpp"
+
+//! Spatial index locating the nodes of the road network.
+/*!
+  The nodes are bucketed in a regular grid over their real coordinates,
+  with about two nodes per cell, stored as a packed array of the nodes of
+  every cell. The nearest node of a location is found by scanning rings of
+  cells of increasing size around it until no closer node can exist.
+
+  The end node of every link is also kept, activities located by a link
+  id being located at the end of this link.
+
+  The index is built from the whole network, or with a sharded network
+  from the network file when activities have to be located (see
+  Data::read_node_locator), and is only read afterwards (it can be queried
+  by several threads).
+ */
+class NodeLocator {
+
+private:
+
+  double                   _min_x;      //!< minimum x coordinate of the grid
+  double                   _min_y;      //!< minimum y coordinate of the grid
+  double                   _cell_size;  //!< side of a cell
+  int                      _n_cols;     //!< number of columns of the grid
+  int                      _n_rows;     //!< number of rows of the grid
+  std::vector<int>         _cell_first; //!< offset of the first node of every cell in _cell_nodes
+  std::vector<int>         _cell_nodes; //!< nodes, grouped by cell
+  std::vector<std::string> _ids;        //!< id of every node
+  std::vector<double>      _x;          //!< real x coordinate of every node
+  std::vector<double>      _y;          //!< real y coordinate of every node
+  std::unordered_map<std::string, std::string> _link_end; //!< end node of every link
+
+  //! Return the cell of a coordinate along one axis, clamped to the grid.
+  int cellOf(double coord, double min_coord, int n_cells) const;
+
+public:
+
+  //! Constructor.
+  NodeLocator() : _min_x(0.0), _min_y(0.0), _cell_size(1.0), _n_cols(0), _n_rows(0) {};
+
+  //! Destructor.
+  ~NodeLocator() {};
+
+  //! Build the index given the whole road network.
+  /*!
+    \param network the road network (nodes real coordinates in XData/YData)
+   */
+  void build(const Network& network);
+
+  //! Add a node to the index, built by index() once every node is added.
+  /*!
+    \param id the node id
+    \param x the real x coordinate of the node
+    \param y the real y coordinate of the node
+   */
+  void addNode(const std::string& id, double x, double y);
+
+  //! Add a link, given its end node.
+  void addLink(const std::string& linkId, const std::string& endNodeId) {
+    _link_end[linkId] = endNodeId;
+  }
+
+  //! Build the grid of the nodes added.
+  void index();
+
+  //! Return the id of the node nearest to a location (Euclidean distance).
+  /*!
+    \param x the x coordinate of the location
+    \param y the y coordinate of the location
+    \return a node id, or an empty string if the network has no node
+   */
+  std::string nearestNode(double x, double y) const;
+
+  //! Return the end node of a link.
+  /*!
+    \param linkId a link id
+    \return a node id, or an empty string if the link is unknown
+   */
+  std::string linkEndNode(const std::string& linkId) const;
+
+  //! Return the number of indexed nodes.
+  unsigned int size() const {
+    return (unsigned int)_ids.size();
+  }
+
+};
+
+#endif /* NODELOCATOR_HPP_ */
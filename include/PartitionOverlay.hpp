@@ -0,0 +1,161 @@
+/****************************************************************
+ * PARTITIONOVERLAY.HPP
+ *
+ * This file contains the overlay graph used to route agents when
+ * every process only stores its own partition of the network.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file PartitionOverlay.hpp
+    \brief Boundary-to-boundary overlay graph of a partitioned network.
+ */
+
+#ifndef PARTITIONOVERLAY_HPP_
+#define PARTITIONOVERLAY_HPP_
+
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <boost/mpi.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "Network.hpp"
+
+//! Overlay graph of the boundary nodes of a partitioned network.
+/*!
+  When the network is sharded (see Data::read_network_partition), every
+  process only stores its partition. The vertices of the overlay are the
+  boundary nodes, i.e. the nodes at one end of a link joining two
+  partitions. Its edges are:
+  - the links joining two partitions;
+  - a shortcut between every pair of boundary nodes of a partition, whose
+    cost is the free flow time of the shortest path inside the partition.
+
+  Every process computes the edges of its partition, and the overlay is
+  then gathered by every process. The distances from the boundary nodes of
+  a partition to a destination it owns (remote completion) are computed on
+  demand by its process, for the processes whose agents head to it: every
+  process only keeps the completions of the destinations it requested.
+
+  A path is computed in three stages: a search inside the local partition,
+  a search on the overlay, and the completion to the destination. Only the
+  part of the path inside the local partition is returned, ending with the
+  link leaving it: the process owning the next partition computes the next
+  part once the agent gets there.
+
+  The overlay is replicated on every process: its size depends on the
+  number of boundary nodes of the whole network, not on the partition.
+ */
+class PartitionOverlay {
+
+private:
+
+  std::vector<std::string>             _vertex_ids;    //!< node id of every overlay vertex, grouped by owner process
+  std::unordered_map<std::string, int> _vertex_index;  //!< overlay index of every boundary node
+  std::vector<int>                     _local_vertices; //!< overlay index of the boundary nodes of the local partition
+  std::vector<int>                     _edge_first;    //!< offset of the first outgoing edge of every vertex
+  std::vector<int>                     _edge_from;     //!< tail of every edge
+  std::vector<int>                     _edge_to;       //!< head of every edge
+  std::vector<float>                   _edge_cost;     //!< cost of every edge
+  std::vector<std::string>             _edge_link;     //!< link of every edge joining two partitions (empty for a shortcut)
+  std::vector<float>                   _local_cost;    //!< free flow time of the local links, the links leaving the partition excluded
+  std::map<std::string, std::vector<std::pair<int, float>>> _completion; //!< (vertex, distance to the destination) of every destination requested
+  std::map<std::string, int>           _completion_owner; //!< process owning every destination requested (-1 if none)
+
+  //! Compute the shortcuts between the boundary nodes of the local partition.
+  void computeShortcuts(const Network& network, std::vector<int>& from, std::vector<int>& to, std::vector<float>& cost) const;
+
+  //! Compute the distances from the local boundary nodes to the destinations of the local partition.
+  /*!
+    Every destination owned gets at least one entry, with a vertex -1 if no
+    boundary node leads to it, so that the requesting process learns its owner.
+
+    \param network the local partition of the network (index built)
+    \param dest_ids the destinations requested, the ones of other partitions being skipped
+    \param slot the position in dest_ids of every distance computed
+    \param vertex the boundary node of every distance computed
+    \param dist the distances computed
+   */
+  void computeCompletion(const Network& network, const std::vector<std::string>& dest_ids,
+                         std::vector<int>& slot, std::vector<int>& vertex, std::vector<float>& dist) const;
+
+public:
+
+  //! Constructor.
+  PartitionOverlay() {};
+
+  //! Destructor.
+  ~PartitionOverlay() {};
+
+  //! Build the overlay given the local partition of the network.
+  /*!
+    This is a collective operation.
+
+    \param network the local partition of the network (index built)
+    \param comm the MPI communicator
+   */
+  void build(const Network& network, boost::mpi::communicator& comm);
+
+  //! Compute the distances from the boundary nodes to the trips destinations.
+  /*!
+    The destinations not requested yet are gathered, and every process
+    computes the distances to the ones it owns, sent back to the processes
+    requesting them only. This is a collective operation, to be called after
+    build, e.g. whenever agents with new destinations reach a process.
+
+    \param network the local partition of the network (index built)
+    \param destinations the trips destinations of the local agents
+    \param comm the MPI communicator
+   */
+  void completeDestinations(const Network& network, const std::set<std::string>& destinations,
+		                    boost::mpi::communicator& comm);
+
+  //! Update the overlay after the free flow time of a few links changed.
+  /*!
+    Only the partitions containing a changed link recompute their
+    shortcuts and the distances to their destinations, the links joining
+    two partitions being updated directly: the completions owned by these
+    partitions are requested again. This is a collective operation.
+
+    \param network the local partition of the network (index built)
+    \param links the index of the local links whose free flow time changed
+    \param comm the MPI communicator
+    \return the number of partitions whose shortcuts were recomputed
+   */
+  unsigned int updateLinks(const Network& network, const std::vector<int>& links, boost::mpi::communicator& comm);
+
+  //! Compute the part of a path lying in the local partition.
+  /*!
+    \param network the local partition of the network (index built)
+    \param source_id the source node id, in the local partition
+    \param dest_id the destination node id (completed by completeDestinations if not local)
+    \param link_id_to_avoid a local link to avoid if possible (none if empty)
+    \return the links leading to the destination, or leaving the partition towards it,
+            in reverse order (empty if the destination cannot be reached)
+   */
+  std::vector<std::string> computePath(const Network& network, const std::string& source_id,
+		                               const std::string& dest_id, const std::string& link_id_to_avoid = "") const;
+
+  //! Return the process owning a destination requested, -1 if unknown.
+  int getDestinationOwner(const std::string& dest_id) const {
+    auto it = _completion_owner.find(dest_id);
+    return it == _completion_owner.end() ? -1 : it->second;
+  }
+
+  //! Return the number of overlay vertices.
+  unsigned int getNVertices() const {
+    return (unsigned int)_vertex_ids.size();
+  }
+
+  //! Return the number of overlay edges.
+  unsigned int getNEdges() const {
+    return (unsigned int)_edge_to.size();
+  }
+
+};
+
+#endif /* PARTITIONOVERLAY_HPP_ */
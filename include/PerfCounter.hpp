@@ -0,0 +1,64 @@
+/****************************************************************
+ * PERFCOUNTER.HPP
+ *
+ * This file contains a hardware event counter of the calling
+ * thread (cache misses), read around the parts of the step to
+ * measure.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file PerfCounter.hpp
+    \brief Cache misses of the calling thread, when the system gives access to them.
+ */
+
+#ifndef PERFCOUNTER_HPP_
+#define PERFCOUNTER_HPP_
+
+//! Counter of the cache misses of the calling thread.
+/*!
+  The counter is a Linux perf event (last level cache misses, user space
+  only). It is unavailable on other systems and when the system forbids
+  the perf events (kernel.perf_event_paranoid, containers): open returns
+  false and the measures are ignored.
+ */
+class PerfCounter {
+
+private:
+
+  int        _fd;       //!< perf event file descriptor (-1 if unavailable)
+  long long  _total;    //!< cache misses counted between start and stop so far
+
+public:
+
+  //! Constructor.
+  PerfCounter() : _fd(-1), _total(0) {};
+
+  //! Destructor, closing the counter.
+  ~PerfCounter();
+
+  //! Open the counter of the calling thread.
+  /*!
+    \return false if the counter is unavailable
+   */
+  bool open();
+
+  //! Check if the counter is available.
+  bool isOpen() const {
+    return _fd >= 0;
+  }
+
+  //! Start counting.
+  void start();
+
+  //! Stop counting, adding the cache misses since start to the total.
+  void stop();
+
+  //! Return the cache misses counted so far.
+  long long getTotal() const {
+    return _total;
+  }
+
+};
+
+#endif /* PERFCOUNTER_HPP_ */
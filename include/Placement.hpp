@@ -0,0 +1,166 @@
+/****************************************************************
+ * PLACEMENT.HPP
+ *
+ * This file contains the placement of the OpenMP threads on the
+ * cores and of the large arrays on the NUMA nodes of the threads
+ * using them.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file Placement.hpp
+    \brief Thread pinning, first-touch placement and huge pages of the large arrays.
+ */
+
+#ifndef PLACEMENT_HPP_
+#define PLACEMENT_HPP_
+
+#include <new>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstddef>
+
+//! Placement of the threads of the process and of its large arrays.
+/*!
+  The memory of a page is taken on the NUMA node of the thread writing it
+  first. An array filled by the master thread thus lies on its socket,
+  the threads of the other socket reading it remotely. Once the threads
+  are pinned (one core each, among the cores given to the process by the
+  MPI launcher), firstTouch rewrites an array in parallel by static
+  chunks, the chunk of a thread being placed on its node, as the chunks
+  of the OpenMP loops over the array. An array read at random by every
+  thread (e.g. a graph searched from any node) gains nothing from it:
+  interleave spreads its pages in turn over the nodes of the threads,
+  so that its reads are shared by their memory controllers.
+ */
+class Placement {
+
+private:
+
+  static bool _huge_pages;   //!< large arrays backed by transparent huge pages
+
+public:
+
+  //! Back the arrays allocated from now on (of at least one huge page) with transparent huge pages.
+  static void setHugePages(bool enabled) {
+    _huge_pages = enabled;
+  }
+
+  //! Check whether the large arrays are backed by transparent huge pages.
+  static bool hasHugePages() {
+    return _huge_pages;
+  }
+
+  //! Allocate a block, aligned on a huge page and advised as such if large enough and enabled.
+  static void* allocate(std::size_t bytes);
+
+  //! Pin every OpenMP thread to one core of the process, in the order of the cores.
+  /*!
+    \return false if the system does not support pinning (the threads being left as they are)
+   */
+  static bool pinThreads();
+
+  //! Return the core and NUMA node of every OpenMP thread, e.g. "0:cpu4/node0 1:cpu5/node0".
+  static std::string describeThreads();
+
+  //! Return the number of pages of a block on every NUMA node, e.g. "node0 120, node1 118".
+  /*!
+    Pages not yet touched are not counted. An empty string is returned if
+    the system does not report it.
+   */
+  static std::string describePages(const void* data, std::size_t bytes);
+
+  //! Set the pages of a block not touched yet to be placed in turn on the NUMA nodes of the threads.
+  /*!
+    Only the pages lying entirely in the block are concerned.
+
+    \return false if the system does not support it (the pages being placed on first touch)
+   */
+  static bool interleavePages(void* data, std::size_t bytes);
+
+  //! Rewrite an array, its pages being placed in turn on the NUMA nodes of the threads.
+  template <class Array>
+  static void interleave(Array& a) {
+    Array placed;
+    placed.resize(a.size());                     // (elements not written by resize, see PlacedAllocator)
+    if( placed.empty() == false ) interleavePages(placed.data(), placed.size() * sizeof(placed[0]));
+    std::copy(a.begin(), a.end(), placed.begin());
+    a.swap(placed);
+  }
+
+  //! Rewrite an array in parallel, its static chunks being placed on the node of the thread processing them.
+  template <class Array>
+  static void firstTouch(Array& a) {
+    Array placed;
+    placed.resize(a.size());                     // (elements not written by resize, see PlacedAllocator)
+    long n = (long)a.size();
+#pragma omp parallel for schedule(static)
+    for( long i = 0; i < n; i++ ) placed[i] = a[i];
+    a.swap(placed);
+  }
+
+};
+
+//! Allocator of the large arrays placed by the threads using them.
+/*!
+  The elements are default-initialised (left unwritten for the integral
+  types), so that resizing an array does not place its pages on the
+  node of the resizing thread, and the blocks are allocated by
+  Placement::allocate (huge pages).
+ */
+template <typename T>
+class PlacedAllocator {
+
+public:
+
+  typedef T value_type;
+
+  PlacedAllocator() {};
+
+  template <typename U>
+  PlacedAllocator(const PlacedAllocator<U>&) {};
+
+  T* allocate(std::size_t n) {
+    void* p = Placement::allocate(n * sizeof(T));
+    if( p == NULL ) throw std::bad_alloc();
+    return static_cast<T*>(p);
+  }
+
+  void deallocate(T* p, std::size_t) {
+    free(p);
+  }
+
+  template <typename U>
+  void construct(U* p) {
+    ::new((void*)p) U;
+  }
+
+  template <typename U, typename... Args>
+  void construct(U* p, Args&&... args) {
+    ::new((void*)p) U(std::forward<Args>(args)...);
+  }
+
+  template <typename U>
+  struct rebind {
+    typedef PlacedAllocator<U> other;
+  };
+
+};
+
+template <typename T, typename U>
+bool operator==(const PlacedAllocator<T>&, const PlacedAllocator<U>&) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const PlacedAllocator<T>&, const PlacedAllocator<U>&) {
+  return false;
+}
+
+//! Array placed by the threads using it.
+template <typename T>
+using PlacedVector = std::vector<T, PlacedAllocator<T>>;
+
+#endif /* PLACEMENT_HPP_ */
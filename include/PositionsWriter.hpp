@@ -0,0 +1,94 @@
+/****************************************************************
+ * POSITIONSWRITER.HPP
+ *
+ * This file contains the writer of the periodic snapshots of the
+ * vehicles positions, in a compact binary format.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file PositionsWriter.hpp
+    \brief Binary stream of the vehicles positions, written in the background.
+ */
+
+#ifndef POSITIONSWRITER_HPP_
+#define POSITIONSWRITER_HPP_
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <condition_variable>
+
+//! Position of a vehicle in a snapshot (12 bytes).
+struct PositionRecord {
+  int32_t agent;     //!< agent index
+  int32_t link;      //!< link index (see the links table written with the stream)
+  float   progress;  //!< fraction of the link already traveled, in [0,1]
+};
+
+//! Writer of the periodic snapshots of the vehicles positions.
+/*!
+  Two files are written, in the native byte order:
+  - the frames (.bin): an 8 bytes header "TSPOS001", then for every frame
+    its time (float) and number of records (uint32), followed by its
+    records (see PositionRecord);
+  - the index (.idx): for every frame its time (float), number of records
+    (uint32) and offset in the frames file (uint64), so that a viewer can
+    seek the frame k at 16 * k in the index.
+
+  The frames are only copied by the simulation: a background thread
+  writes them, so that a snapshot barely delays the step.
+ */
+class PositionsWriter {
+
+private:
+
+  FILE*                           _file_frames;  //!< frames file
+  FILE*                           _file_index;   //!< index file
+  uint64_t                        _offset;       //!< offset of the next frame in the frames file
+  std::deque<std::vector<char>>   _queue;        //!< frames waiting to be written
+  std::mutex                      _mutex;        //!< lock of the queue
+  std::condition_variable         _cond;         //!< signals a new frame or the closing
+  bool                            _closing;      //!< no more frames will be added
+  std::thread                     _thread;       //!< background writing thread
+
+  //! Write the queued frames until the writer is closed.
+  void run();
+
+public:
+
+  //! Constructor.
+  PositionsWriter() : _file_frames(NULL), _file_index(NULL), _offset(0), _closing(false) {};
+
+  //! Destructor, writing the remaining frames.
+  ~PositionsWriter();
+
+  //! Open the stream and start the background thread.
+  /*!
+    \param basename path of the files, without their .bin and .idx extensions
+    \return false if the files cannot be opened
+   */
+  bool open(const std::string& basename);
+
+  //! Check if the stream is open.
+  bool isOpen() const {
+    return _file_frames != NULL;
+  }
+
+  //! Add a frame to the stream.
+  /*!
+    \param time the simulation time of the frame
+    \param records the positions of the vehicles
+   */
+  void addFrame(float time, const std::vector<PositionRecord>& records);
+
+  //! Write the remaining frames and close the stream.
+  void close();
+
+};
+
+#endif /* POSITIONSWRITER_HPP_ */
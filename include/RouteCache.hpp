@@ -0,0 +1,193 @@
+/****************************************************************
+ * ROUTECACHE.HPP
+ *
+ * This file contains the paths cache distributed among the
+ * processes, every (origin, destination) pair being owned by one
+ * process, fronted by a small local cache.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file RouteCache.hpp
+    \brief Rank-sharded paths cache with batched remote lookups.
+ */
+
+#ifndef ROUTECACHE_HPP_
+#define ROUTECACHE_HPP_
+
+#include <map>
+#include <list>
+#include <set>
+#include <vector>
+#include <string>
+#include <utility>
+#include <unordered_map>
+#include <boost/mpi.hpp>
+
+#include "Network.hpp"
+
+//! Paths of a bounded cache, the least recently used being evicted first.
+class PathStore {
+
+private:
+
+  typedef std::pair<std::vector<int>, std::list<long>::iterator> Entry;
+
+  unsigned int                    _capacity; //!< maximum number of paths
+  std::list<long>                 _order;    //!< keys, most recently used first
+  std::unordered_map<long, Entry> _paths;    //!< path (links index, in reverse order) and position in _order of every key
+
+public:
+
+  //! Constructor.
+  PathStore(unsigned int capacity = 0) : _capacity(capacity) {};
+
+  //! Set the maximum number of paths.
+  void setCapacity(unsigned int capacity) {
+    _capacity = capacity;
+  }
+
+  //! Return the path of a key, if stored.
+  const std::vector<int>* find(long key);
+
+  //! Store the path of a key, evicting the least recently used path if full.
+  void insert(long key, const std::vector<int>& path);
+
+  //! Remove the paths using one of the given links.
+  /*!
+    \return the number of paths removed
+   */
+  unsigned int eraseUsing(const std::set<int>& links);
+
+  //! Return the number of paths stored.
+  unsigned int size() const {
+    return (unsigned int)_paths.size();
+  }
+
+};
+
+//! Paths cache distributed among the processes.
+/*!
+  A local cache on every process would hold the popular paths once per
+  process, and still compute the paths another process already knows.
+  Here every (origin, destination) pair is owned by one process (hash of
+  the pair), which stores its path in a bounded shard.
+
+  The paths needed by a process are requested in batches: every request
+  is sent to the owner of its pair in one sparse exchange (only the
+  non-empty messages are sent), the owner computing once the paths it
+  does not know, and the paths are sent back to the processes which will
+  use them. They are kept there in a small near cache, which also keeps
+  the paths computed locally.
+
+  Every process holds the whole network with the same index, paths being
+  exchanged as lists of link indices.
+ */
+class RouteCache {
+
+private:
+
+  PathStore                       _shard;      //!< paths of the pairs owned by the process
+  PathStore                       _near;       //!< paths recently delivered to or computed by the process
+  std::vector<std::vector<int>>   _requests;   //!< (origin index, destination index, process receiving the path) of the requests, by owner
+  std::set<long>                  _requested;  //!< pairs already requested since the last exchange
+  unsigned long                   _n_hits;     //!< requests answered by the owner shards
+  unsigned long                   _n_misses;   //!< requests computed by their owner
+
+  //! Return the key of a pair.
+  long key(const Network& network, int origin, int dest) const {
+    return (long)origin * network.getNNodesIndexed() + dest;
+  }
+
+  //! Return the process owning a pair.
+  int owner(long key, int n_proc) const;
+
+public:
+
+  //! Constructor.
+  RouteCache() : _n_hits(0), _n_misses(0) {};
+
+  //! Destructor.
+  ~RouteCache() {};
+
+  //! Set the maximum number of paths of the shard and of the near cache.
+  void setCapacity(unsigned int shard, unsigned int near) {
+    _shard.setCapacity(shard);
+    _near.setCapacity(near);
+  }
+
+  //! Request a path, delivered at the next exchange.
+  /*!
+    \param network the road network (index built, identical on every process)
+    \param origin_id the origin node id
+    \param dest_id the destination node id
+    \param deliver_to the process receiving the path
+    \param n_proc the number of processes
+   */
+  void request(const Network& network, const std::string& origin_id, const std::string& dest_id,
+		       int deliver_to, int n_proc);
+
+  //! Return the number of requests not exchanged yet.
+  unsigned int size() const {
+    return (unsigned int)_requested.size();
+  }
+
+  //! Look up a path in the near cache.
+  /*!
+    \param network the road network
+    \param origin_id the origin node id
+    \param dest_id the destination node id
+    \param path the path (links, in reverse order), if found
+    \return true if the path is in the near cache
+   */
+  bool find(const Network& network, const std::string& origin_id, const std::string& dest_id,
+		    std::vector<std::string>& path);
+
+  //! Check whether a path is in the near cache.
+  bool contains(const Network& network, const std::string& origin_id, const std::string& dest_id);
+
+  //! Keep a path computed locally in the near cache.
+  void insert(const Network& network, const std::string& origin_id, const std::string& dest_id,
+		      const std::vector<std::string>& path);
+
+  //! Answer the requests of every process.
+  /*!
+    This is a collective operation. On return, the requested paths are in
+    the near cache of the processes receiving them, and also in delivered
+    if given: a batch larger than the near cache would otherwise evict
+    paths before they are used.
+
+    \param network the road network (index built, identical on every process)
+    \param comm the MPI communicator
+    \param cost if not NULL, the cost of every link (ordered by link index) the paths minimise instead of the free flow time
+    \param delivered if not NULL, the paths (links index, in reverse order) received, by (origin index, destination index)
+    \return the number of paths computed by the local process
+   */
+  unsigned int exchange(Network& network, boost::mpi::communicator& comm, const std::vector<float>* cost = NULL,
+                        std::map<std::pair<int, int>, std::vector<int>>* delivered = NULL);
+
+  //! Remove the paths using one of the given links from the shard and the near cache.
+  /*!
+    \param links the index of the links
+    \return the number of paths removed
+   */
+  unsigned int invalidateLinks(const std::set<int>& links);
+
+  //! Return the number of requests answered by the local shard.
+  unsigned long getNHits() const {
+    return _n_hits;
+  }
+
+  //! Return the number of requests computed by the local process.
+  unsigned long getNMisses() const {
+    return _n_misses;
+  }
+
+  //! Return the number of paths of the local shard.
+  unsigned int getShardSize() const {
+    return _shard.size();
+  }
+
+};
+
+#endif /* ROUTECACHE_HPP_ */
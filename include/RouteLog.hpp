@@ -0,0 +1,129 @@
+/****************************************************************
+ * ROUTELOG.HPP
+ *
+ * This file contains the log of the routing requests, in a
+ * compact binary format, and its reader.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file RouteLog.hpp
+    \brief Binary log of the routing requests, replayed by bench_routes.
+ */
+
+#ifndef ROUTELOG_HPP_
+#define ROUTELOG_HPP_
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+
+#include "Network.hpp"
+
+//! Call site of a routing request.
+enum class RouteSite : uint8_t {
+  INITIAL   = 0,  //!< initial path of an agent (look up table or near cache)
+  DEPARTURE = 1,  //!< path deferred to the departure of the agent (look up table or near cache)
+  NEXT_TRIP = 2,  //!< path of the next trip, computed at the arrival of the agent
+  REROUTE   = 3,  //!< new path of a strategic agent avoiding its next link
+  TREE_EXIT = 4,  //!< destination not reachable through its destination tree
+  PUBLISHED = 5   //!< request published to the route tasks or the distributed cache, computed in a batch
+};
+
+//! Algorithm and cost answering a routing request.
+enum class RouteMetric : uint8_t {
+  ASTAR    = 0,  //!< A* at free flow
+  DIJKSTRA = 1,  //!< Dijkstra at free flow
+  AVOID    = 2,  //!< Dijkstra at free flow avoiding a link
+  TABLE    = 3,  //!< Dijkstra on the costs of the link times table
+  OVERLAY  = 4,  //!< partition overlay (sharded network)
+  CACHED   = 5   //!< path found in the look up table or the near cache, not computed
+};
+
+//! Routing request of the log (24 bytes).
+struct RouteRecord {
+  float    time;      //!< simulated time of the request (s)
+  uint32_t latency;   //!< time spent computing or looking up the path (ns, 0 if computed in a batch)
+  int32_t  source;    //!< source node index (see the nodes table written with the log)
+  int32_t  dest;      //!< destination node index
+  int32_t  avoid;     //!< link to avoid index (see the links table written with the log), -1 if none
+  uint8_t  site;      //!< call site (see RouteSite)
+  uint8_t  metric;    //!< algorithm and cost (see RouteMetric)
+  uint16_t n_links;   //!< number of links of the path found (saturated at 65535)
+};
+
+//! Log of the routing requests.
+/*!
+  The file is written in the native byte order: an 8 bytes header
+  "TSRTE001", the number of nodes and of links (uint32), the nodes ids
+  then the links ids of the network index (null terminated strings), and
+  the requests (see RouteRecord) until the end of the file. The ids let a
+  replay map the requests on its own network index.
+
+  The requests are buffered and written by blocks. The log is not thread
+  safe: the routing requests of the model are issued by the main thread.
+ */
+class RouteLog {
+
+private:
+
+  FILE*                     _file;     //!< log file
+  std::vector<RouteRecord>  _buffer;   //!< requests not written yet
+
+  //! Write the buffered requests.
+  void flush();
+
+public:
+
+  //! Constructor.
+  RouteLog() : _file(NULL) {};
+
+  //! Destructor, writing the remaining requests.
+  ~RouteLog();
+
+  //! Open the log and write its header and the ids of the network index.
+  /*!
+    \param filename path of the log
+    \param network the indexed network the requests refer to
+    \return false if the file cannot be opened
+   */
+  bool open(const std::string& filename, const Network& network);
+
+  //! Check if the log is open.
+  bool isOpen() const {
+    return _file != NULL;
+  }
+
+  //! Add a request to the log.
+  /*!
+    \param network the network given to open
+    \param site the call site
+    \param metric the algorithm and cost used
+    \param source_id the source node id
+    \param dest_id the destination node id
+    \param link_id_to_avoid the link avoided (none if empty)
+    \param time the simulated time
+    \param latency the time spent computing the path (s)
+    \param n_links the number of links of the path found
+   */
+  void add(const Network& network, RouteSite site, RouteMetric metric, const std::string& source_id, const std::string& dest_id,
+           const std::string& link_id_to_avoid, float time, double latency, size_t n_links);
+
+  //! Write the remaining requests and close the log.
+  void close();
+
+  //! Read a log.
+  /*!
+    \param filename path of the log
+    \param node_ids the nodes ids of the network index of the log (output)
+    \param link_ids the links ids of the network index of the log (output)
+    \param records the requests (output)
+    \return false if the file cannot be read or is not a log of routing requests
+   */
+  static bool read(const std::string& filename, std::vector<std::string>& node_ids, std::vector<std::string>& link_ids,
+                   std::vector<RouteRecord>& records);
+
+};
+
+#endif /* ROUTELOG_HPP_ */
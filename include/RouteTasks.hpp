@@ -0,0 +1,102 @@
+/****************************************************************
+ * ROUTETASKS.HPP
+ *
+ * This file contains the routing requests shared among the
+ * processes, idle processes taking over the requests of the busy
+ * ones.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file RouteTasks.hpp
+    \brief Routing requests balanced across processes by work stealing.
+ */
+
+#ifndef ROUTETASKS_HPP_
+#define ROUTETASKS_HPP_
+
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include <utility>
+#include <boost/mpi.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "Network.hpp"
+
+//! Routing requests published by the processes and computed by any of them.
+/*!
+  Routing load is uneven: the processes owning residential areas compute
+  most of the paths of the morning departures. Instead of computing them
+  immediately, a process publishes its requests (origin, destination) as
+  tasks. When the tasks are run, every process first takes tasks from its
+  own queue and then steals from the queues of the others, a chunk at a
+  time, until every queue is empty. A chunk is claimed by atomically
+  incrementing the counter of the queue through one-sided MPI, so that
+  no process has to answer the requests of the others.
+
+  Every process holding the whole network with the same index, a path is
+  sent back as a compact list of link indices to the process which will
+  use it.
+ */
+class RouteTasks {
+
+private:
+
+  std::vector<std::string>               _origins;    //!< origin node of every published task
+  std::vector<std::string>               _dests;      //!< destination node of every published task
+  std::vector<int>                       _deliver_to; //!< process receiving the path of every published task
+  std::set<std::pair<std::string, std::string>> _published; //!< (origin, destination) already published
+  int                                    _chunk;      //!< number of tasks claimed at once
+
+public:
+
+  //! Constructor.
+  /*!
+    \param chunk number of tasks claimed at once
+   */
+  RouteTasks(int chunk = 8) : _chunk(chunk) {};
+
+  //! Destructor.
+  ~RouteTasks() {};
+
+  //! Set the number of tasks claimed at once.
+  void setChunk(int chunk) {
+    _chunk = std::max(chunk, 1);
+  }
+
+  //! Publish a routing request.
+  /*!
+    \param origin_id the origin node id
+    \param dest_id the destination node id
+    \param deliver_to the process receiving the path
+   */
+  void publish(const std::string& origin_id, const std::string& dest_id, int deliver_to);
+
+  //! Return the number of tasks published locally and not run yet.
+  unsigned int size() const {
+    return (unsigned int)_origins.size();
+  }
+
+  //! Compute the tasks published by every process.
+  /*!
+    This is a collective operation. On return, the paths delivered to the
+    local process are added to paths, and the local queue is empty.
+
+    \param network the road network (index built, identical on every process)
+    \param comm the MPI communicator
+    \param paths the paths (in reverse order) by origin and destination
+    \param delivered if not NULL, receives the (origin, destination) of the paths added
+    \param cost if not NULL, the cost of every link (ordered by link index) the paths minimise instead of the free flow time
+    \return the number of tasks computed by the local process
+   */
+  unsigned int run(Network& network, boost::mpi::communicator& comm,
+		           std::map<std::string, std::map<std::string, std::vector<std::string>>>& paths,
+		           std::vector<std::pair<std::string, std::string>>* delivered = NULL,
+		           const std::vector<float>* cost = NULL);
+
+};
+
+#endif /* ROUTETASKS_HPP_ */
@@ -9,7 +9,9 @@
 #define TRIP_HPP_
 
 #include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
 #include <string>
+#include <vector>
 
 class Trip {
 
@@ -22,11 +24,13 @@ private:
 	  ar & _id_origin;
 	  ar & _id_destination;
 	  ar & _starting_time;
+	  ar & _path;
   }
 
   std::string  _id_origin;
   std::string  _id_destination;
   float _starting_time;
+  std::vector<std::string> _path;   // precomputed path (links in reverse order), empty if it has to be computed
 
 public:
 
@@ -58,6 +62,14 @@ public:
 	  _id_origin = idOrigin;
   }
 
+  const std::vector<std::string>& getPath() const {
+	  return _path;
+  }
+
+  void setPath(const std::vector<std::string>& path) {
+	  _path = path;
+  }
+
 };
 
 
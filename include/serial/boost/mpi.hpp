@@ -0,0 +1,20 @@
+/****************************************************************
+ * MPI.HPP
+ *
+ * This file contains the part of Boost.MPI used by the simulator,
+ * for a single process (serial build).
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file mpi.hpp
+    \brief Single process Boost.MPI of the serial build.
+ */
+
+#ifndef SERIAL_BOOST_MPI_HPP_
+#define SERIAL_BOOST_MPI_HPP_
+
+#include "mpi/communicator.hpp"
+#include "mpi/collectives.hpp"
+
+#endif /* SERIAL_BOOST_MPI_HPP_ */
@@ -0,0 +1,90 @@
+/****************************************************************
+ * COLLECTIVES.HPP
+ *
+ * This file contains the Boost.MPI collective operations for a
+ * single process (serial build): the result of every operation is
+ * the contribution of the process.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file collectives.hpp
+    \brief Single process Boost.MPI collectives of the serial build.
+ */
+
+#ifndef SERIAL_BOOST_MPI_COLLECTIVES_HPP_
+#define SERIAL_BOOST_MPI_COLLECTIVES_HPP_
+
+#include <vector>
+#include <algorithm>
+#include "communicator.hpp"
+
+namespace boost {
+namespace mpi {
+
+//! Minimum of two values.
+template <typename T>
+struct minimum {
+  const T& operator()(const T& x, const T& y) const {
+    return x < y ? x : y;
+  }
+};
+
+//! Maximum of two values.
+template <typename T>
+struct maximum {
+  const T& operator()(const T& x, const T& y) const {
+    return x < y ? y : x;
+  }
+};
+
+template <typename T>
+void all_gather(const communicator&, const T& in_value, std::vector<T>& out_values) {
+  out_values.assign(1, in_value);
+}
+
+template <typename T, typename Op>
+void all_reduce(const communicator&, const T& in_value, T& out_value, Op) {
+  out_value = in_value;
+}
+
+template <typename T, typename Op>
+T all_reduce(const communicator&, const T& in_value, Op) {
+  return in_value;
+}
+
+template <typename T, typename Op>
+void all_reduce(const communicator&, const T* in_values, int n, T* out_values, Op) {
+  std::copy(in_values, in_values + n, out_values);
+}
+
+template <typename T, typename Op>
+void reduce(const communicator&, const T& in_value, T& out_value, Op, int) {
+  out_value = in_value;
+}
+
+template <typename T, typename Op>
+void reduce(const communicator&, const T* in_values, int n, T* out_values, Op, int) {
+  std::copy(in_values, in_values + n, out_values);
+}
+
+template <typename T>
+void gather(const communicator&, const T& in_value, std::vector<T>& out_values, int) {
+  out_values.assign(1, in_value);
+}
+
+template <typename T>
+void gather(const communicator&, const T&, int) {}
+
+template <typename T>
+void broadcast(const communicator&, T&, int) {}
+
+template <typename T>
+void all_to_all(const communicator&, const std::vector<T>& in_values, std::vector<T>& out_values) {
+  out_values = in_values;
+}
+
+} // namespace mpi
+} // namespace boost
+
+#endif /* SERIAL_BOOST_MPI_COLLECTIVES_HPP_ */
@@ -0,0 +1,136 @@
+/****************************************************************
+ * COMMUNICATOR.HPP
+ *
+ * This file contains the Boost.MPI environment and communicator
+ * for a single process (serial build).
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file communicator.hpp
+    \brief Single process Boost.MPI communicator of the serial build.
+ */
+
+#ifndef SERIAL_BOOST_MPI_COMMUNICATOR_HPP_
+#define SERIAL_BOOST_MPI_COMMUNICATOR_HPP_
+
+#include <list>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "../../mpi.h"
+
+namespace boost {
+namespace mpi {
+
+//! MPI environment (nothing to initialize).
+class environment {
+
+public:
+
+  environment() {};
+  environment(int&, char**&, bool = true) {};
+
+};
+
+//! Request of a non-blocking communication, completed when posted.
+class request {
+
+public:
+
+  void wait() {};
+
+};
+
+//! Wait for the completion of requests.
+template <class Iterator>
+void wait_all(Iterator, Iterator) {}
+
+//! Communicator of the single process.
+/*!
+  The messages a process sends to itself are kept until the matching
+  receive is posted (or copied at once into a receive already posted),
+  so that both the send and the receive complete when posted. Only
+  arrays of trivially copyable values are exchanged.
+ */
+class communicator {
+
+private:
+
+  //! A message waiting for its receive, or a receive waiting for its message.
+  struct Pending {
+    int                tag;     //!< tag of the message
+    std::vector<char>  data;    //!< message sent
+    void*              buffer;  //!< receive buffer
+    size_t             bytes;   //!< size of the receive buffer
+  };
+
+  //! Return the messages sent and not received yet.
+  static std::list<Pending>& sent() {
+    static std::list<Pending> messages;
+    return messages;
+  }
+
+  //! Return the receives posted before their message.
+  static std::list<Pending>& posted() {
+    static std::list<Pending> receives;
+    return receives;
+  }
+
+public:
+
+  communicator() {};
+
+  int rank() const {
+    return 0;
+  }
+
+  int size() const {
+    return 1;
+  }
+
+  void barrier() const {};
+
+  void abort(int errcode) const {
+    std::exit(errcode);
+  }
+
+  operator MPI_Comm() const {
+    return MPI_COMM_WORLD;
+  }
+
+  template <typename T>
+  request isend(int, int tag, const T* values, int n) const {
+    size_t bytes = n * sizeof(T);
+    for( auto it = posted().begin(); it != posted().end(); it++ ) {
+      if( it->tag != tag ) continue;
+      memcpy(it->buffer, values, std::min(bytes, it->bytes));
+      posted().erase(it);
+      return request();
+    }
+    Pending p = { tag, std::vector<char>((const char*)values, (const char*)values + bytes), NULL, 0 };
+    sent().push_back(p);
+    return request();
+  }
+
+  template <typename T>
+  request irecv(int, int tag, T* values, int n) const {
+    size_t bytes = n * sizeof(T);
+    for( auto it = sent().begin(); it != sent().end(); it++ ) {
+      if( it->tag != tag ) continue;
+      memcpy(values, it->data.data(), std::min(bytes, it->data.size()));
+      sent().erase(it);
+      return request();
+    }
+    Pending p = { tag, std::vector<char>(), values, bytes };
+    posted().push_back(p);
+    return request();
+  }
+
+};
+
+} // namespace mpi
+} // namespace boost
+
+#endif /* SERIAL_BOOST_MPI_COMMUNICATOR_HPP_ */
@@ -0,0 +1,75 @@
+/****************************************************************
+ * MPI.H
+ *
+ * This file contains the part of the MPI C interface used by the
+ * simulator, for a single process (serial build).
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file mpi.h
+    \brief Single process MPI interface of the serial build.
+ */
+
+#ifndef SERIAL_MPI_H_
+#define SERIAL_MPI_H_
+
+#include <cstdlib>
+
+#define MPI_SUCCESS    0
+#define MPI_INFO_NULL  0
+#define MPI_COMM_WORLD 0
+
+//! Communicator, the only one being the single process.
+typedef int MPI_Comm;
+
+//! Info object (unused).
+typedef int MPI_Info;
+
+//! Type of the elements of the one-sided operations.
+enum MPI_Datatype { MPI_INT };
+
+//! Reduction operation of the one-sided operations.
+enum MPI_Op { MPI_SUM };
+
+//! Window of the one-sided operations, exposing memory of the process.
+struct MPI_Win_s {
+  void*  base;       //!< exposed memory
+  int    disp_unit;  //!< size of a displacement unit
+};
+typedef MPI_Win_s* MPI_Win;
+
+inline int MPI_Win_create(void* base, long, int disp_unit, MPI_Info, MPI_Comm, MPI_Win* win) {
+  *win = new MPI_Win_s;
+  (*win)->base      = base;
+  (*win)->disp_unit = disp_unit;
+  return MPI_SUCCESS;
+}
+
+inline int MPI_Win_free(MPI_Win* win) {
+  delete *win;
+  *win = NULL;
+  return MPI_SUCCESS;
+}
+
+inline int MPI_Win_lock_all(int, MPI_Win) {
+  return MPI_SUCCESS;
+}
+
+inline int MPI_Win_unlock_all(MPI_Win) {
+  return MPI_SUCCESS;
+}
+
+inline int MPI_Win_flush(int, MPI_Win) {
+  return MPI_SUCCESS;
+}
+
+//! Atomically add to an int of the window, returning its previous value (MPI_INT and MPI_SUM only).
+inline int MPI_Fetch_and_op(const void* origin, void* result, MPI_Datatype, int, long disp, MPI_Op, MPI_Win win) {
+  int* target = (int*)( (char*)win->base + disp * win->disp_unit );
+  *(int*)result = *target;
+  *target += *(const int*)origin;
+  return MPI_SUCCESS;
+}
+
+#endif /* SERIAL_MPI_H_ */
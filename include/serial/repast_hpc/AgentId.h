@@ -0,0 +1,132 @@
+/****************************************************************
+ * AGENTID.H
+ *
+ * This file contains the Repast HPC agents id and agent interface
+ * for a single process (serial build).
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file AgentId.h
+    \brief Agents id of the serial build.
+ */
+
+#ifndef SERIAL_REPAST_AGENTID_H_
+#define SERIAL_REPAST_AGENTID_H_
+
+#include <cstddef>
+#include <iostream>
+#include <boost/functional/hash.hpp>
+
+namespace repast {
+
+//! Agent id: id, starting process and type of the agent, with the process it is on.
+/*!
+  The hash code is the one of Repast HPC, for the agents of a context
+  to be stored (and thus iterated) in the same order.
+ */
+class AgentId {
+
+private:
+
+  int          id_;
+  int          startProc_;
+  int          agentType_;
+  int          currentProc_;
+  std::size_t  hash;
+
+  friend bool operator==(const AgentId& one, const AgentId& two);
+  friend bool operator<(const AgentId& one, const AgentId& two);
+  friend std::ostream& operator<<(std::ostream& os, const AgentId& id);
+
+public:
+
+  AgentId() : id_(0), startProc_(0), agentType_(0), currentProc_(0), hash(0) {};
+
+  AgentId(int id, int startProc, int agentType, int currentProc = -1) :
+    id_(id), startProc_(startProc), agentType_(agentType), currentProc_(currentProc == -1 ? startProc : currentProc) {
+    hash = 17;
+    hash = 31 * hash + boost::hash_value(id_);
+    hash = 31 * hash + boost::hash_value(startProc_);
+    hash = 31 * hash + boost::hash_value(agentType_);
+  }
+
+  virtual ~AgentId() {};
+
+  int id() const {
+    return id_;
+  }
+
+  int startingRank() const {
+    return startProc_;
+  }
+
+  int agentType() const {
+    return agentType_;
+  }
+
+  int currentRank() const {
+    return currentProc_;
+  }
+
+  void currentRank(int val) {
+    currentProc_ = val;
+  }
+
+  std::size_t hashcode() const {
+    return hash;
+  }
+
+  template <class Archive>
+  void serialize(Archive& ar, const unsigned int version) {
+    ar & id_;
+    ar & startProc_;
+    ar & agentType_;
+    ar & currentProc_;
+    ar & hash;
+  }
+
+};
+
+inline bool operator==(const AgentId& one, const AgentId& two) {
+  return one.id_ == two.id_ && one.startProc_ == two.startProc_ && one.agentType_ == two.agentType_;
+}
+
+inline bool operator!=(const AgentId& one, const AgentId& two) {
+  return !( one == two );
+}
+
+inline bool operator<(const AgentId& one, const AgentId& two) {
+  if( one.agentType_ != two.agentType_ ) return one.agentType_ < two.agentType_;
+  if( one.startProc_ != two.startProc_ ) return one.startProc_ < two.startProc_;
+  return one.id_ < two.id_;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const AgentId& id) {
+  os << "AgentId(" << id.id_ << ", " << id.startProc_ << ", " << id.agentType_ << ", " << id.currentProc_ << ")";
+  return os;
+}
+
+//! Hash of the agents id.
+struct HashId {
+  std::size_t operator()(const AgentId& id) const {
+    return id.hashcode();
+  }
+};
+
+//! Agent interface.
+class Agent {
+
+public:
+
+  virtual ~Agent() {};
+
+  virtual AgentId& getId() = 0;
+
+  virtual const AgentId& getId() const = 0;
+
+};
+
+} // namespace repast
+
+#endif /* SERIAL_REPAST_AGENTID_H_ */
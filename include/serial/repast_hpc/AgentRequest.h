@@ -0,0 +1,43 @@
+/****************************************************************
+ * AGENTREQUEST.H
+ *
+ * This file contains the Repast HPC agents request for a single
+ * process (serial build), never sent since every agent is local.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file AgentRequest.h
+    \brief Agents request of the serial build.
+ */
+
+#ifndef SERIAL_REPAST_AGENTREQUEST_H_
+#define SERIAL_REPAST_AGENTREQUEST_H_
+
+#include <vector>
+#include "AgentId.h"
+
+namespace repast {
+
+//! Request of the agents of other processes.
+class AgentRequest {
+
+private:
+
+  std::vector<AgentId> _requested;
+
+public:
+
+  void addRequest(const AgentId& id) {
+    _requested.push_back(id);
+  }
+
+  const std::vector<AgentId>& requestedAgents() const {
+    return _requested;
+  }
+
+};
+
+} // namespace repast
+
+#endif /* SERIAL_REPAST_AGENTREQUEST_H_ */
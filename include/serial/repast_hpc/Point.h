@@ -0,0 +1,88 @@
+/****************************************************************
+ * POINT.H
+ *
+ * This file contains the Repast HPC points and grid dimensions for
+ * a single process (serial build).
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file Point.h
+    \brief Points and grid dimensions of the serial build.
+ */
+
+#ifndef SERIAL_REPAST_POINT_H_
+#define SERIAL_REPAST_POINT_H_
+
+#include <vector>
+#include <iostream>
+
+namespace repast {
+
+//! Point in two dimensions.
+template <typename T>
+class Point {
+
+private:
+
+  std::vector<T> point;
+
+public:
+
+  Point(T x, T y) : point({ x, y }) {};
+
+  T getX() const {
+    return point[0];
+  }
+
+  T getY() const {
+    return point[1];
+  }
+
+  const std::vector<T>& coords() const {
+    return point;
+  }
+
+};
+
+template <typename T>
+std::ostream& operator<<(std::ostream& os, const Point<T>& pt) {
+  os << "Point[";
+  for( size_t i = 0; i < pt.coords().size(); i++ ) {
+    if( i > 0 ) os << ", ";
+    os << pt.coords()[i];
+  }
+  os << "]";
+  return os;
+}
+
+//! Origin and extents of a grid.
+class GridDimensions {
+
+private:
+
+  Point<double> _origin;
+  Point<double> _extents;
+
+public:
+
+  GridDimensions(const Point<double>& origin, const Point<double>& extents) : _origin(origin), _extents(extents) {};
+
+  const Point<double>& origin() const {
+    return _origin;
+  }
+
+  const Point<double>& extents() const {
+    return _extents;
+  }
+
+};
+
+inline std::ostream& operator<<(std::ostream& os, const GridDimensions& dimensions) {
+  os << "GridDimensions(Origin:[" << dimensions.origin() << "], Extent: [" << dimensions.extents() << "])";
+  return os;
+}
+
+} // namespace repast
+
+#endif /* SERIAL_REPAST_POINT_H_ */
@@ -0,0 +1,127 @@
+/****************************************************************
+ * PROPERTIES.H
+ *
+ * This file contains the Repast HPC properties for a single
+ * process (serial build).
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file Properties.h
+    \brief Properties of the serial build.
+ */
+
+#ifndef SERIAL_REPAST_PROPERTIES_H_
+#define SERIAL_REPAST_PROPERTIES_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <boost/mpi.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string/trim.hpp>
+
+namespace repast {
+
+//! Properties (key = value) read from a file and from the command line arguments.
+/*!
+  The files are read and written as by Repast HPC: '#' starts a comment
+  line, and the arguments "key=value" override the file.
+ */
+class Properties {
+
+private:
+
+  std::map<std::string, std::string> map;
+
+public:
+
+  Properties() {};
+
+  Properties(const std::string& file, boost::mpi::communicator* comm = 0) {
+    readFile(file);
+  }
+
+  Properties(const std::string& file, int argc, char** argv, boost::mpi::communicator* comm = 0) {
+    readFile(file);
+    processCommandLineArguments(argc, argv);
+  }
+
+  void putProperty(const std::string& key, std::string value) {
+    map[key] = value;
+  }
+
+  void putProperty(const std::string& key, long double value) {
+    map[key] = std::to_string(value);
+  }
+
+  std::string getProperty(const std::string& key) const {
+    auto it = map.find(key);
+    if( it == map.end() ) return "";
+    return it->second;
+  }
+
+  bool contains(const std::string& key) const {
+    return map.find(key) != map.end();
+  }
+
+  int size() const {
+    return (int)map.size();
+  }
+
+  void readFile(const std::string& file) {
+    std::ifstream in(file.c_str(), std::ios::in);
+    if( in.is_open() == false ) {
+      std::cerr << "Properties file " << file << " not found" << std::endl;
+      throw "Properties file not found";
+    }
+    std::string line;
+    while( getline(in, line) ) {
+      boost::algorithm::trim(line);
+      if( line.empty() == true || line[0] == '#' ) continue;
+      size_t pos = line.find('=');
+      std::string key   = pos == std::string::npos ? "" : boost::algorithm::trim_copy(line.substr(0, pos));
+      std::string value = pos == std::string::npos ? "" : boost::algorithm::trim_copy(line.substr(pos + 1));
+      if( key.empty() == true || value.empty() == true ) {
+        std::cerr << "Malformed line '" << line << "' in properties file " << file << std::endl;
+        throw "Malformed properties file";
+      }
+      map[key] = value;
+    }
+  }
+
+  void processCommandLineArguments(int argc, char** argv) {
+    for( int i = 0; i < argc; i++ ) {
+      std::string entry(argv[i]);
+      size_t pos = entry.find('=');
+      if( pos != std::string::npos ) putProperty(entry.substr(0, pos), entry.substr(pos + 1));
+    }
+  }
+
+  //! Log the properties (the serial build has no logger).
+  void log(std::string logName) {}
+
+  void writeToSVFile(std::string fileName, std::vector<std::string>& keysToWrite, std::string separator = ",") {
+    bool writeHeader = !boost::filesystem::exists(fileName);
+    std::ofstream out(fileName.c_str(), std::ios::app);
+    if( writeHeader == true ) {
+      for( size_t i = 0; i < keysToWrite.size(); i++ ) out << keysToWrite[i] << ( i + 1 != keysToWrite.size() ? separator : "" );
+      out << std::endl;
+    }
+    for( size_t i = 0; i < keysToWrite.size(); i++ ) out << std::fixed << getProperty(keysToWrite[i]) << ( i + 1 != keysToWrite.size() ? separator : "" );
+    out << std::endl;
+  }
+
+  void writeToSVFile(std::string fileName, std::string separator = ",") {
+    std::vector<std::string> keys;
+    for( const auto& p : map ) keys.push_back(p.first);
+    writeToSVFile(fileName, keys, separator);
+  }
+
+};
+
+} // namespace repast
+
+#endif /* SERIAL_REPAST_PROPERTIES_H_ */
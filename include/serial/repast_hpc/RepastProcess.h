@@ -0,0 +1,87 @@
+/****************************************************************
+ * REPASTPROCESS.H
+ *
+ * This file contains the Repast HPC process for a single process
+ * (serial build): its schedule and communicator, the agents never
+ * leaving it.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file RepastProcess.h
+    \brief Repast process of the serial build.
+ */
+
+#ifndef SERIAL_REPAST_REPASTPROCESS_H_
+#define SERIAL_REPAST_REPASTPROCESS_H_
+
+#include <string>
+#include <boost/mpi.hpp>
+
+#include "Schedule.h"
+#include "AgentId.h"
+#include "AgentRequest.h"
+
+namespace repast {
+
+//! The single process of the simulation.
+class RepastProcess {
+
+private:
+
+  boost::mpi::communicator*  _comm;    //!< communicator of the process
+  ScheduleRunner             _runner;  //!< schedule of the simulation
+
+  static RepastProcess*& process() {
+    static RepastProcess* p = NULL;
+    return p;
+  }
+
+  RepastProcess(boost::mpi::communicator* comm) : _comm(comm) {};
+
+public:
+
+  //! Create the process (the Repast configuration file is not read).
+  static RepastProcess* init(std::string config, boost::mpi::communicator* comm = 0, int maxConfigFileSize = 0) {
+    if( process() == NULL ) process() = new RepastProcess(comm != 0 ? comm : new boost::mpi::communicator());
+    return process();
+  }
+
+  static RepastProcess* instance() {
+    return process();
+  }
+
+  void done() {
+    delete process();
+    process() = NULL;
+  }
+
+  int rank() {
+    return 0;
+  }
+
+  int worldSize() {
+    return 1;
+  }
+
+  boost::mpi::communicator* getCommunicator() {
+    return _comm;
+  }
+
+  boost::mpi::communicator* communicator() {
+    return _comm;
+  }
+
+  ScheduleRunner& getScheduleRunner() {
+    return _runner;
+  }
+
+  //! Synchronize the agents moving to other processes (none).
+  template <typename T, typename Content, typename Provider, typename Updater, typename AgentCreator, typename Context>
+  void synchronizeAgentStatus(Context&, Provider&, Updater&, AgentCreator&) {}
+
+};
+
+} // namespace repast
+
+#endif /* SERIAL_REPAST_REPASTPROCESS_H_ */
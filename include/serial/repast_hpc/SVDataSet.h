@@ -0,0 +1,190 @@
+/****************************************************************
+ * SVDATASET.H
+ *
+ * This file contains the Repast HPC separated values data sets for
+ * a single process (serial build).
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file SVDataSet.h
+    \brief Separated values data sets of the serial build.
+ */
+
+#ifndef SERIAL_REPAST_SVDATASET_H_
+#define SERIAL_REPAST_SVDATASET_H_
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <boost/filesystem.hpp>
+
+#include "Schedule.h"
+#include "TDataSource.h"
+
+namespace repast {
+
+//! Data set interface.
+class DataSet {
+
+public:
+
+  virtual ~DataSet() {};
+
+  virtual void record() = 0;
+
+  virtual void write() = 0;
+
+  virtual void close() = 0;
+
+};
+
+//! A column of a separated values data set.
+class SVDataSource {
+
+private:
+
+  std::string _name;
+
+public:
+
+  SVDataSource(const std::string& name) : _name(name) {};
+
+  virtual ~SVDataSource() {};
+
+  const std::string& name() const {
+    return _name;
+  }
+
+  //! Record the current data.
+  virtual void record() = 0;
+
+  //! Write a recorded data.
+  virtual void write(size_t index, std::ostream& out) = 0;
+
+  //! Forget the recorded data.
+  virtual void clear() = 0;
+
+};
+
+//! Column of the data of a source, reduced over the processes (a single one here).
+template <typename Op, typename T>
+class ReducibleDataSource : public SVDataSource {
+
+private:
+
+  TDataSource<T>*  _source;
+  std::vector<T>   _data;
+
+public:
+
+  ReducibleDataSource(const std::string& name, TDataSource<T>* source, Op op) : SVDataSource(name), _source(source) {};
+
+  void record() {
+    _data.push_back(_source->getData());
+  }
+
+  void write(size_t index, std::ostream& out) {
+    out << _data[index];
+  }
+
+  void clear() {
+    _data.clear();
+  }
+
+};
+
+template <typename Op>
+SVDataSource* createSVDataSource(std::string name, TDataSource<int>* intDataSource, Op op) {
+  return new ReducibleDataSource<Op, int>(name, intDataSource, op);
+}
+
+template <typename Op>
+SVDataSource* createSVDataSource(std::string name, TDataSource<double>* doubleDataSource, Op op) {
+  return new ReducibleDataSource<Op, double>(name, doubleDataSource, op);
+}
+
+//! Data set written in a separated values file, a row per recorded tick.
+/*!
+  As by Repast HPC, an existing file is not overwritten: a suffix _2,
+  _3, ... is added to the name of the new file.
+ */
+class SVDataSet : public DataSet {
+
+private:
+
+  std::string                 _separator;
+  const Schedule*             _schedule;
+  std::ofstream               out;
+  bool                        open;
+  std::vector<SVDataSource*>  dataSources;
+  std::vector<double>         ticks;
+
+public:
+
+  SVDataSet(const std::string& file, const std::string& separator, const Schedule* schedule) :
+    _separator(separator), _schedule(schedule), open(true) {
+    boost::filesystem::path filepath(file);
+    if( filepath.has_parent_path() == true && boost::filesystem::exists(filepath.parent_path()) == false ) {
+      boost::filesystem::create_directories(filepath.parent_path());
+    }
+    std::string stem = filepath.stem().string();
+    for( int i = 2; boost::filesystem::exists(filepath) == true; i++ ) {
+      std::stringstream ss;
+      ss << stem << "_" << i << filepath.extension().string();
+      filepath = filepath.parent_path() / ss.str();
+    }
+    out.open(filepath.string().c_str());
+  }
+
+  ~SVDataSet() {
+    close();
+  }
+
+  void addDataSource(SVDataSource* source) {
+    dataSources.push_back(source);
+  }
+
+  //! Write the header.
+  void init() {
+    out << "\"tick\"";
+    for( auto ds : dataSources ) out << _separator << "\"" << ds->name() << "\"";
+    out << std::endl;
+    out.flush();
+  }
+
+  void record() {
+    if( open == false ) throw "Data set not open";
+    ticks.push_back(_schedule->getCurrentTick());
+    for( auto ds : dataSources ) ds->record();
+  }
+
+  void write() {
+    if( open == false ) throw "Data set not open";
+    for( size_t t = 0; t < ticks.size(); t++ ) {
+      out << ticks[t];
+      for( auto ds : dataSources ) {
+        out << _separator;
+        ds->write(t, out);
+      }
+      out << std::endl;
+    }
+    for( auto ds : dataSources ) ds->clear();
+    ticks.clear();
+    out.flush();
+  }
+
+  void close() {
+    if( open == false ) return;
+    out.close();
+    for( auto ds : dataSources ) delete ds;
+    dataSources.clear();
+    open = false;
+  }
+
+};
+
+} // namespace repast
+
+#endif /* SERIAL_REPAST_SVDATASET_H_ */
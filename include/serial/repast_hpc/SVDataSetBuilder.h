@@ -0,0 +1,57 @@
+/****************************************************************
+ * SVDATASETBUILDER.H
+ *
+ * This file contains the Repast HPC builder of the separated values
+ * data sets for a single process (serial build).
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file SVDataSetBuilder.h
+    \brief Builder of the separated values data sets of the serial build.
+ */
+
+#ifndef SERIAL_REPAST_SVDATASETBUILDER_H_
+#define SERIAL_REPAST_SVDATASETBUILDER_H_
+
+#include <string>
+#include <vector>
+
+#include "Schedule.h"
+#include "SVDataSet.h"
+
+namespace repast {
+
+//! Builder of a separated values data set.
+class SVDataSetBuilder {
+
+private:
+
+  std::string                 _file;
+  std::string                 _separator;
+  const Schedule*             _schedule;
+  std::vector<SVDataSource*>  _sources;
+
+public:
+
+  SVDataSetBuilder(const std::string& file, const std::string& separator, const Schedule& schedule) :
+    _file(file), _separator(separator), _schedule(&schedule) {};
+
+  SVDataSetBuilder& addDataSource(SVDataSource* source) {
+    _sources.push_back(source);
+    return *this;
+  }
+
+  SVDataSet* createDataSet() {
+    SVDataSet* dataSet = new SVDataSet(_file, _separator, _schedule);
+    for( auto s : _sources ) dataSet->addDataSource(s);
+    dataSet->init();
+    _sources.clear();
+    return dataSet;
+  }
+
+};
+
+} // namespace repast
+
+#endif /* SERIAL_REPAST_SVDATASETBUILDER_H_ */
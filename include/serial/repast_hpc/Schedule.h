@@ -0,0 +1,195 @@
+/****************************************************************
+ * SCHEDULE.H
+ *
+ * This file contains the Repast HPC schedule for a single process
+ * (serial build).
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file Schedule.h
+    \brief Schedule of the serial build.
+ */
+
+#ifndef SERIAL_REPAST_SCHEDULE_H_
+#define SERIAL_REPAST_SCHEDULE_H_
+
+#include <queue>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace repast {
+
+//! Functor interface.
+class Functor {
+
+public:
+
+  virtual ~Functor() {};
+
+  virtual void operator()() = 0;
+
+};
+
+//! Functor calling a method of an object.
+template <typename T>
+class MethodFunctor : public Functor {
+
+private:
+
+  void (T::*fptr)();
+  T* obj;
+
+public:
+
+  MethodFunctor(T* _obj, void (T::*_fptr)()) : fptr(_fptr), obj(_obj) {};
+
+  void operator()() {
+    (obj->*fptr)();
+  }
+
+};
+
+//! An event of the schedule, repeated if its interval is positive.
+struct ScheduledEvent {
+  double                      tick;      //!< next tick of the event
+  double                      interval;  //!< interval between the executions, 0 if executed once
+  boost::shared_ptr<Functor>  func_ptr;  //!< function executed
+};
+
+//! Order of the events in the queue, the earliest first.
+class EventCompare {
+
+public:
+
+  int operator()(const ScheduledEvent* one, const ScheduledEvent* two) {
+    return one->tick > two->tick ? 1 : 0;
+  }
+
+};
+
+//! Events queue.
+/*!
+  The queue, its comparison and the order of the pushes are the ones of
+  Repast HPC, so that the events of a tick are executed in the same order.
+ */
+class Schedule {
+
+private:
+
+  typedef std::priority_queue<ScheduledEvent*, std::vector<ScheduledEvent*>, EventCompare> QueueType;
+
+  QueueType queue;
+  double    currentTick;
+
+public:
+
+  typedef boost::shared_ptr<Functor> FunctorPtr;
+
+  Schedule() : currentTick(0.0) {};
+
+  ~Schedule() {
+    while( queue.empty() == false ) {
+      delete queue.top();
+      queue.pop();
+    }
+  }
+
+  ScheduledEvent* schedule_event(double at, FunctorPtr func) {
+    return schedule_event(at, 0.0, func);
+  }
+
+  ScheduledEvent* schedule_event(double start, double interval, FunctorPtr func) {
+    ScheduledEvent* evt = new ScheduledEvent{ start, interval, func };
+    queue.push(evt);
+    return evt;
+  }
+
+  //! Execute every event of the next tick.
+  void execute() {
+    if( queue.empty() == true ) return;
+    ScheduledEvent* evt = queue.top();
+    double next = evt->tick;
+    currentTick = next;
+    bool go = true;
+    while( go == true ) {
+      queue.pop();
+      (*evt->func_ptr)();
+      if( evt->interval > 0.0 ) {
+        evt->tick += evt->interval;
+        queue.push(evt);
+      }
+      else {
+        delete evt;
+      }
+      if( queue.empty() == true ) go = false;
+      else {
+        evt = queue.top();
+        go = evt->tick == next;
+      }
+    }
+  }
+
+  double getCurrentTick() const {
+    return currentTick;
+  }
+
+  double getNextTick() const {
+    if( queue.empty() == true ) return -1;
+    return queue.top()->tick;
+  }
+
+};
+
+//! Runs the schedule until it is stopped, then the end events.
+class ScheduleRunner : public boost::noncopyable {
+
+private:
+
+  bool                     go;
+  Schedule                 schedule_;
+  std::vector<Schedule::FunctorPtr> endEvents;
+
+public:
+
+  ScheduleRunner() : go(true) {};
+
+  ScheduledEvent* scheduleEvent(double at, Schedule::FunctorPtr func) {
+    return schedule_.schedule_event(at, func);
+  }
+
+  ScheduledEvent* scheduleEvent(double start, double interval, Schedule::FunctorPtr func) {
+    return schedule_.schedule_event(start, interval, func);
+  }
+
+  void scheduleEndEvent(Schedule::FunctorPtr func) {
+    endEvents.push_back(func);
+  }
+
+  void scheduleStop(double at) {
+    schedule_.schedule_event(at, Schedule::FunctorPtr(new MethodFunctor<ScheduleRunner>(this, &ScheduleRunner::stop)));
+  }
+
+  void run() {
+    while( go == true && schedule_.getNextTick() >= 0 ) schedule_.execute();
+    for( size_t i = 0; i < endEvents.size(); i++ ) (*endEvents[i])();
+  }
+
+  void stop() {
+    go = false;
+  }
+
+  double currentTick() const {
+    return schedule_.getCurrentTick();
+  }
+
+  const Schedule& schedule() const {
+    return schedule_;
+  }
+
+};
+
+} // namespace repast
+
+#endif /* SERIAL_REPAST_SCHEDULE_H_ */
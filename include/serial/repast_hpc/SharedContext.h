@@ -0,0 +1,127 @@
+/****************************************************************
+ * SHAREDCONTEXT.H
+ *
+ * This file contains the Repast HPC agents context for a single
+ * process (serial build), every agent being local.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file SharedContext.h
+    \brief Agents context of the serial build.
+ */
+
+#ifndef SERIAL_REPAST_SHAREDCONTEXT_H_
+#define SERIAL_REPAST_SHAREDCONTEXT_H_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+#include <boost/mpi.hpp>
+
+#include "AgentId.h"
+
+namespace repast {
+
+//! Projection of the agents of a context (e.g. a space).
+template <typename T>
+class Projection {
+
+public:
+
+  virtual ~Projection() {};
+
+  virtual void addAgent(boost::shared_ptr<T> agent) = 0;
+
+  virtual void removeAgent(T* agent) = 0;
+
+};
+
+//! Agent of an entry of the agents map.
+template <typename T>
+struct SecondElement {
+  typedef boost::shared_ptr<T> result_type;
+  boost::shared_ptr<T> operator()(const typename boost::unordered_map<AgentId, boost::shared_ptr<T>, HashId>::value_type& value) const {
+    return value.second;
+  }
+};
+
+//! Agents of the process.
+/*!
+  The agents are stored in the map of Repast HPC (same container and
+  hash), so that they are iterated in the same order as by a 1 process
+  run of the parallel build.
+ */
+template <typename T>
+class SharedContext {
+
+private:
+
+  typedef boost::unordered_map<AgentId, boost::shared_ptr<T>, HashId> AgentMap;
+
+  AgentMap                     agents;
+  std::vector<Projection<T>*>  projections;
+
+public:
+
+  typedef boost::transform_iterator<SecondElement<T>, typename AgentMap::const_iterator> const_local_iterator;
+
+  SharedContext(boost::mpi::communicator* comm = 0) {};
+
+  ~SharedContext() {
+    for( auto proj : projections ) delete proj;
+  }
+
+  T* addAgent(T* agent) {
+    const AgentId& id = agent->getId();
+    auto it = agents.find(id);
+    if( it != agents.end() ) return it->second.get();
+    boost::shared_ptr<T> ptr(agent);
+    agents[id] = ptr;
+    for( auto proj : projections ) proj->addAgent(ptr);
+    return agent;
+  }
+
+  void removeAgent(const AgentId id) {
+    auto it = agents.find(id);
+    if( it == agents.end() ) return;
+    for( auto proj : projections ) proj->removeAgent(it->second.get());
+    agents.erase(it);
+  }
+
+  void removeAgent(T* agent) {
+    removeAgent(agent->getId());
+  }
+
+  T* getAgent(const AgentId& id) {
+    auto it = agents.find(id);
+    if( it == agents.end() ) return 0;
+    return it->second.get();
+  }
+
+  bool contains(const AgentId& id) {
+    return agents.find(id) != agents.end();
+  }
+
+  int size() const {
+    return (int)agents.size();
+  }
+
+  void addProjection(Projection<T>* projection) {
+    projections.push_back(projection);
+  }
+
+  const_local_iterator localBegin() const {
+    return const_local_iterator(agents.begin());
+  }
+
+  const_local_iterator localEnd() const {
+    return const_local_iterator(agents.end());
+  }
+
+};
+
+} // namespace repast
+
+#endif /* SERIAL_REPAST_SHAREDCONTEXT_H_ */
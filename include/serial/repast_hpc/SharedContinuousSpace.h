@@ -0,0 +1,72 @@
+/****************************************************************
+ * SHAREDCONTINUOUSSPACE.H
+ *
+ * This file contains the Repast HPC continuous space for a single
+ * process (serial build), the process owning the whole space.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file SharedContinuousSpace.h
+    \brief Continuous space of the serial build.
+ */
+
+#ifndef SERIAL_REPAST_SHAREDCONTINUOUSSPACE_H_
+#define SERIAL_REPAST_SHAREDCONTINUOUSSPACE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/mpi.hpp>
+
+#include "Point.h"
+#include "AgentId.h"
+#include "SharedContext.h"
+
+namespace repast {
+
+//! Borders wrapping around (the locations are not checked).
+class WrapAroundBorders {};
+
+//! Adder of the agents (the agents are located when moved).
+template <typename T>
+class SimpleAdder {};
+
+//! Space of the agents, the locations being kept by their agent.
+template <typename T, typename Borders, typename Adder>
+class SharedContinuousSpace : public Projection<T> {
+
+private:
+
+  std::string     _name;
+  GridDimensions  _dimensions;
+
+public:
+
+  SharedContinuousSpace(std::string name, GridDimensions dimensions, std::vector<int> processDims,
+                        int buffer, boost::mpi::communicator* comm) : _name(name), _dimensions(dimensions) {};
+
+  void addAgent(boost::shared_ptr<T>) {}
+
+  void removeAgent(T*) {}
+
+  bool moveTo(const AgentId&, const Point<double>&) {
+    return true;
+  }
+
+  //! Move the agents to other processes (none).
+  void balance(std::map<AgentId, int>&) {}
+
+  const GridDimensions& dimensions() const {
+    return _dimensions;
+  }
+
+  const GridDimensions& bounds() const {
+    return _dimensions;
+  }
+
+};
+
+} // namespace repast
+
+#endif /* SERIAL_REPAST_SHAREDCONTINUOUSSPACE_H_ */
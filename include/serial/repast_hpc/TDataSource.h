@@ -0,0 +1,33 @@
+/****************************************************************
+ * TDATASOURCE.H
+ *
+ * This file contains the Repast HPC data sources interface for a
+ * single process (serial build).
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file TDataSource.h
+    \brief Data sources interface of the serial build.
+ */
+
+#ifndef SERIAL_REPAST_TDATASOURCE_H_
+#define SERIAL_REPAST_TDATASOURCE_H_
+
+namespace repast {
+
+//! Source of the data recorded by a data set.
+template <typename T>
+class TDataSource {
+
+public:
+
+  virtual ~TDataSource() {};
+
+  virtual T getData() = 0;
+
+};
+
+} // namespace repast
+
+#endif /* SERIAL_REPAST_TDATASOURCE_H_ */
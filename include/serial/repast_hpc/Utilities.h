@@ -0,0 +1,62 @@
+/****************************************************************
+ * UTILITIES.H
+ *
+ * This file contains the Repast HPC utilities used by the
+ * simulator, for a single process (serial build).
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file Utilities.h
+    \brief Utilities of the serial build.
+ */
+
+#ifndef SERIAL_REPAST_UTILITIES_H_
+#define SERIAL_REPAST_UTILITIES_H_
+
+#include <ctime>
+#include <chrono>
+#include <string>
+#include <cstdlib>
+
+namespace repast {
+
+//! Timer of the wall clock time.
+class Timer {
+
+private:
+
+  std::chrono::steady_clock::time_point _start;
+
+public:
+
+  void start() {
+    _start = std::chrono::steady_clock::now();
+  }
+
+  //! Return the time (s) elapsed since the start.
+  long double stop() {
+    return std::chrono::duration<long double>(std::chrono::steady_clock::now() - _start).count();
+  }
+
+};
+
+//! Current date and time.
+inline void timestamp(std::string& str) {
+  char buffer[32];
+  time_t now = time(NULL);
+  strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", localtime(&now));
+  str = buffer;
+}
+
+inline int strToInt(const std::string& str) {
+  return atoi(str.c_str());
+}
+
+inline double strToDouble(const std::string& str) {
+  return atof(str.c_str());
+}
+
+} // namespace repast
+
+#endif /* SERIAL_REPAST_UTILITIES_H_ */
@@ -0,0 +1,8 @@
+/****************************************************************
+ * LOGGER.H
+ *
+ * Nothing of this Repast HPC header is used by the simulator in a
+ * single process (serial build).
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
@@ -14,16 +14,167 @@ using namespace std;
 using namespace repast;
 using namespace tinyxml2;
 
+//! Call visit on the attributes of every element of a given name of a XML file, read as a stream.
+/*!
+  Unlike a XMLDocument, the file is never held in memory. The scan ends at the
+  end of the file, or at the first element named stop_at.
+
+  \param filename path to the XML file
+  \param name name of the elements to visit
+  \param stop_at name of the element ending the scan (none if empty)
+  \param visit function called with the attributes of every element found
+ */
+static void for_each_xml_element(const string& filename, const string& name, const string& stop_at,
+                                 const function<void(const map<string, string>&)>& visit) {
+
+	ifstream file(filename.c_str(), ios::in);
+	if( !file ) {
+		cerr << "Could not open " << filename << endl;
+		throw "Could not open the network file";
+	}
+
+	// is tag an element called element_name?
+	auto is_element = [](const string& tag, const string& element_name) {
+		if( tag.compare(0, element_name.size(), element_name) != 0 ) return false;
+		if( tag.size() == element_name.size() ) return true;
+		char next = tag[element_name.size()];
+		return next == ' ' || next == '\t' || next == '\n' || next == '\r' || next == '/';
+	};
+
+	// replacing the predefined entities of an attribute value
+	auto unescape = [](string value) {
+		static const vector<pair<string, string>> entities = { {"&lt;", "<"}, {"&gt;", ">"}, {"&quot;", "\""}, {"&apos;", "'"}, {"&amp;", "&"} };
+		for( const auto& e : entities ) {
+			size_t pos = 0;
+			while( ( pos = value.find(e.first, pos) ) != string::npos ) {
+				value.replace(pos, e.first.size(), e.second);
+				pos += e.second.size();
+			}
+		}
+		return value;
+	};
+
+	string skipped, tag;
+	map<string, string> attributes;
+	while( getline(file, skipped, '<') && getline(file, tag, '>') ) {
+
+		if( stop_at.empty() == false && is_element(tag, stop_at) == true ) break;
+		if( is_element(tag, name) == false ) continue;
+
+		// attributes written key="value" or key='value'
+		attributes.clear();
+		size_t pos = name.size();
+		while( true ) {
+			size_t eq = tag.find('=', pos);
+			if( eq == string::npos ) break;
+			size_t quote = tag.find_first_of("\"'", eq);
+			if( quote == string::npos ) break;
+			size_t end = tag.find(tag[quote], quote + 1);
+			if( end == string::npos ) break;
+			string key = tag.substr(pos, eq - pos);
+			key.erase(0, key.find_first_not_of(" \t\n\r"));
+			key.erase(key.find_last_not_of(" \t\n\r") + 1);
+			attributes[key] = unescape(tag.substr(quote + 1, end - quote - 1));
+			pos = end + 1;
+		}
+
+		visit(attributes);
+
+	}
+
+}
+
 ////////////////
 // Data class //
 ////////////////
 
+void Data::read_network_partition(const function<void(const NodeVisitor&)>& read_nodes,
+                                  const function<void(const LinkVisitor&)>& read_links) {
+
+	int rank   = RepastProcess::instance()->rank();
+	int n_proc = RepastProcess::instance()->worldSize();
+
+	// Bounding box of the whole network
+	double min_x = numeric_limits<double>::max(), max_x = -numeric_limits<double>::max();
+	double min_y = numeric_limits<double>::max(), max_y = -numeric_limits<double>::max();
+	read_nodes([&](const string&, double x, double y) {
+		min_x = min(min_x, x);
+		max_x = max(max_x, x);
+		min_y = min(min_y, y);
+		max_y = max(max_y, y);
+	});
+
+	// Ranges of the processes along the Hilbert curve, each holding the same number of nodes
+	// (only the positions of the nodes are kept meanwhile)
+	this->_network.setPartition(rank, min_x, max_x, min_y, max_y, vector<unsigned long>(1, 0));
+	vector<unsigned long> keys;
+	read_nodes([&](const string&, double x, double y) {
+		keys.push_back(this->_network.getCurveKey(x, y));
+	});
+	sort(keys.begin(), keys.end());
+
+	vector<unsigned long> first_keys(n_proc, 0);
+	for( int r = 1; r < n_proc && keys.empty() == false; r++ ) first_keys[r] = keys[(long)r * (long)keys.size() / n_proc];
+	vector<unsigned long>().swap(keys);
+	this->_network.setPartition(rank, min_x, max_x, min_y, max_y, first_keys);
+
+	// Nodes of the partition...
+	read_nodes([&](const string& id, double x, double y) {
+		if( this->_network.getOwnerAt(x, y) == rank ) this->_network.addNode(Node(id, x, y));
+	});
+
+	// ... links entering or leaving it...
+	vector<Link> links;
+	set<string> boundary_nodes;
+	read_links([&](const Link& lnk) {
+		bool start_in = this->_network.getNodes().count(lnk.getStartNodeId()) == 1;
+		bool end_in   = this->_network.getNodes().count(lnk.getEndNodeId())   == 1;
+		if( start_in == false && end_in == false ) return;
+		links.push_back(lnk);
+		if( start_in == false ) boundary_nodes.insert(lnk.getStartNodeId());
+		if( end_in   == false ) boundary_nodes.insert(lnk.getEndNodeId());
+	});
+
+	// ... and nodes at the other end of these links
+	read_nodes([&](const string& id, double x, double y) {
+		if( boundary_nodes.count(id) == 1 ) this->_network.addNode(Node(id, x, y));
+	});
+
+	this->_network.shuffleNodesCoordinates();
+
+	for( auto& lnk : links ) {
+		lnk.setX(this->_network.getNodes().at(lnk.getStartNodeId()).getX());
+		lnk.setY(this->_network.getNodes().at(lnk.getStartNodeId()).getY());
+		this->_network.addLinkOutToNode(lnk.getStartNodeId(), lnk.getId());
+		this->_network.addLink(lnk);
+	}
+
+}
+
 void Data::read_network_matsim() {
 
 	if (RepastProcess::instance()->rank() == 0) cout << "... reading network" << endl;
 
-	// Loading XML file containing the network data.
 	string filename = this->_props.getProperty("file.network_matsim");
+
+	// A sharded network is streamed, only the partition of the process being kept
+	if( isSharded() == true ) {
+		auto read_nodes = [&filename](const NodeVisitor& visit) {
+			for_each_xml_element(filename, "node", "links", [&visit](const map<string, string>& attr) {
+				visit(attr.at("id"), boost::lexical_cast<double>(attr.at("x")), boost::lexical_cast<double>(attr.at("y")));
+			});
+		};
+		auto read_links = [&filename](const LinkVisitor& visit) {
+			for_each_xml_element(filename, "link", "", [&visit](const map<string, string>& attr) {
+				visit(Link(attr.at("id"), attr.at("from"), attr.at("to"), boost::lexical_cast<float>(attr.at("length")),
+				           boost::lexical_cast<float>(attr.at("freespeed")), boost::lexical_cast<float>(attr.at("capacity")), 0, 0));
+			});
+		};
+		read_network_partition(read_nodes, read_links);
+		return;
+	}
+
+	// Loading XML file containing the network data.
 	XMLDocument doc(filename.c_str());
 	doc.loadFile(filename.c_str());
 
@@ -106,6 +257,21 @@ void Data::read_network_matsim() {
 	
 
 
+}
+
+void Data::read_node_locator(NodeLocator& locator) const {
+
+	string filename = this->_props.getProperty("file.network_matsim");
+
+	for_each_xml_element(filename, "node", "links", [&locator](const map<string, string>& attr) {
+		locator.addNode(attr.at("id"), boost::lexical_cast<double>(attr.at("x")), boost::lexical_cast<double>(attr.at("y")));
+	});
+	for_each_xml_element(filename, "link", "", [&locator](const map<string, string>& attr) {
+		locator.addLink(attr.at("id"), attr.at("to"));
+	});
+
+	locator.index();
+
 }
 
 void Data::read_network_transims() {
@@ -116,30 +282,79 @@ void Data::read_network_transims() {
 	ifstream file;                                                    // an input stream extracting from a file
 	string a_line;                                                    // a line of data
 
-	// Nodes ///////////////////////////////////////////////////////////////////////////////
+	// calling visit on every node of the nodes file
+	string nodes_filename = this->_props.getProperty("file.nodes_transims");
+	auto read_nodes = [&nodes_filename](const NodeVisitor& visit) {
+		ifstream file(nodes_filename.c_str(), ios::in);
+		string a_line;
+		if(file) {
+			getline(file, a_line);
+			while (getline(file, a_line)) {
+				auto data = split<string>(a_line,"\t");
+				auto id = boost::lexical_cast<string>(data[0]);
+				auto x  = boost::lexical_cast<double>(data[1]);
+				auto y  = boost::lexical_cast<double>(data[2]);
+				visit(id, x, y);
+			}
+			file.close();
+		} else {
+			cerr << "Could not open " << nodes_filename << endl;
+		}
+	};
 
-	if (RepastProcess::instance()->rank() == 0) cout << "       parsing nodes" << endl;
+	// calling visit on every link of the links file (walking paths removed), 2-way links giving their return link as well
+	string links_filename = this->_props.getProperty("file.links_transims");
+	auto read_links = [&links_filename](const LinkVisitor& visit) {
+		ifstream file(links_filename.c_str(), ios::in);
+		string a_line;
+		if (file) {
+			getline(file, a_line);                                          // dropping the first line
+			while (getline(file, a_line)) {
 
-	filename = this->_props.getProperty("file.nodes_transims");       // path to data
-	file.open(filename.c_str(), ios::in);                             // opening data file
+				// extracting data
+				auto data     = split<string>(a_line, "\t");
+				string type   = data[21];
 
-	// file reading
-	if(file) {
-		getline(file, a_line);
-		while (getline(file, a_line)) {
-			auto data = split<string>(a_line,"\t");
-			auto id = boost::lexical_cast<string>(data[0]);
-			auto x  = boost::lexical_cast<double>(data[1]);
-			auto y  = boost::lexical_cast<double>(data[2]);
+				// removing walking paths
+				if( type.compare("WALK") == 0 ) continue;
 
-			Node cur_node(id, x, y);
-			this->_network.addNode(cur_node);
+				auto id_link  = boost::lexical_cast<string>(data[0]);
+				auto id_orig  = boost::lexical_cast<string>(data[2]);
+				auto id_dest  = boost::lexical_cast<string>(data[3]);
+				auto length   = boost::lexical_cast<float>(data[4]);
+				auto ff_speed = boost::lexical_cast<float>(data[15]);
+				auto capacity = boost::lexical_cast<float>(data[16]);
+				visit(Link(id_link, id_orig, id_dest, length, ff_speed, capacity, 0, 0));
+
+				// checking if current link is 2-way
+				auto return_link_lanes = boost::lexical_cast<unsigned int>(data[17]);
+				if ( return_link_lanes > 0 ) {
+					auto ff_speed_return = boost::lexical_cast<float>(data[19]);
+					auto capacity_return = boost::lexical_cast<float>(data[20]);
+					visit(Link("-"+id_link, id_dest, id_orig, length, ff_speed_return, capacity_return, 0, 0));
+				}
 
+			}
+			file.close();
+		} else {
+			cerr << "Could not open " << links_filename << endl;
 		}
-		file.close();
-		this->_network.shuffleNodesCoordinates();               // shuffling coordinates
+	};
+
+	// Nodes ///////////////////////////////////////////////////////////////////////////////
+
+	if (RepastProcess::instance()->rank() == 0) cout << "       parsing nodes" << endl;
+
+	// ... a sharded network only keeping the partition of the process, and the links entering or leaving it
+	if( isSharded() == true ) {
+		if (RepastProcess::instance()->rank() == 0) cout << "       parsing links" << endl;
+		read_network_partition(read_nodes, read_links);
 	} else {
-		cerr << "Could not open " << filename << endl;
+		read_nodes([this](const string& id, double x, double y) {
+			Node cur_node(id, x, y);
+			this->_network.addNode(cur_node);
+		});
+		this->_network.shuffleNodesCoordinates();              // shuffling coordinates
 	}
 
 	// Nodes - Activities location matching ////////////////////////////////////////////////
@@ -166,84 +381,34 @@ void Data::read_network_transims() {
 
 	// Links ///////////////////////////////////////////////////////////////////////////////
 
-	if (RepastProcess::instance()->rank() == 0) cout << "       parsing links" << endl;
-
-	filename = this->_props.getProperty("file.links_transims");
-	file.open(filename.c_str(), ios::in);                             // opening data file
-
-	// file reading
-	if (file) {
-		getline(file, a_line);                                          // dropping the first line
-		while (getline(file, a_line)) {
+	if( isSharded() == false ) {
 
-			// extracting data
-			auto data     = split<string>(a_line, "\t");
-			string type   = data[21];
+		if (RepastProcess::instance()->rank() == 0) cout << "       parsing links" << endl;
 
-			// removing walking paths
-			if( type.compare("WALK") != 0 ) {
+		read_links([this](const Link& lnk) {
 
-				auto id_link  = boost::lexical_cast<string>(data[0]);
-				auto id_orig  = boost::lexical_cast<string>(data[2]);
-				auto id_dest  = boost::lexical_cast<string>(data[3]);
-				auto length   = boost::lexical_cast<float>(data[4]);
-				auto ff_speed = boost::lexical_cast<float>(data[15]);
-				auto capacity = boost::lexical_cast<float>(data[16]);
+			Link currLink = lnk;
+			currLink.setX(this->_network.getNodes().at(lnk.getStartNodeId()).getX());
+			currLink.setY(this->_network.getNodes().at(lnk.getStartNodeId()).getY());
 
-				auto link_x = this->_network.getNodes().at(id_orig).getX();
-				auto link_y = this->_network.getNodes().at(id_orig).getY();
-
-
-				// adding the link to the list of outgoing links of node id_orig
-				this->_network.addLinkOutToNode(id_orig, id_link);
-
-				// adding the link to the network
-				Link currLink(id_link, id_orig, id_dest, length, ff_speed, capacity, link_x, link_y);
-				this->_network.addLink(currLink);
-
-#ifdef DEBUGDATA
-				if (RepastProcess::instance()->rank() == 0) {
-					cout << "Adding link " << id_link << " with chars : " << id_orig << " " << id_dest << " " << length << " " << capacity << " ";
-					cout << ff_speed << " " << link_x << " " << link_y << endl;
-				}
-#endif
-
-				// checking if current link is 2-way
-				auto return_link_lanes = boost::lexical_cast<unsigned int>(data[17]);
-				if ( return_link_lanes > 0 ) {
-					auto id_return_link = "-"+id_link;
-					auto id_return_orig = id_dest;
-					auto id_return_dest = id_orig;
-					auto ff_speed_return = boost::lexical_cast<float>(data[19]);
-					auto capacity_return = boost::lexical_cast<float>(data[20]);
-					auto link_x_return = this->_network.getNodes().at(id_return_orig).getX();
-					auto link_y_return = this->_network.getNodes().at(id_return_orig).getY();
-
-					// adding the links to the map tracking 2-ways links
-					this->_map_2way_links[id_link] = id_return_link;
-
-					// adding the link to the list of outgoing links of node id_orig
-					this->_network.addLinkOutToNode(id_return_orig, id_return_link);
-
-					// adding the link to the network
-					Link currLinkReturn(id_return_link, id_return_orig, id_return_dest, length, ff_speed_return, capacity_return, link_x_return, link_y_return);
-					this->_network.addLink(currLinkReturn);
+			// adding the link to the list of outgoing links of its origin node, and to the network
+			this->_network.addLinkOutToNode(currLink.getStartNodeId(), currLink.getId());
+			this->_network.addLink(currLink);
 
 #ifdef DEBUGDATA
-					if (RepastProcess::instance()->rank() == 0) {
-						cout << "Adding return link " << id_return_link << "with chars : " << id_return_orig << " " << id_return_dest << " " << length << " " << capacity_return << " ";
-						cout << ff_speed_return << " " << link_x_return << " " << link_y_return << endl;
-					}
+			if (RepastProcess::instance()->rank() == 0) {
+				cout << "Adding link " << currLink.getId() << " with chars : " << currLink.getStartNodeId() << " " << currLink.getEndNodeId() << " ";
+				cout << currLink.getLength() << " " << currLink.getCapacity() << " " << currLink.getX() << " " << currLink.getY() << endl;
+			}
 #endif
 
-				}
+		});
 
-			}
+	}
 
-		}
-		file.close();
-	} else {
-		cerr << "Could not open " << filename << endl;
+	// the map tracking 2-way links, from the return links kept
+	for( const auto& lnk : this->_network.getLinks() ) {
+		if( lnk.first.compare(0, 1, "-") == 0 ) this->_map_2way_links[lnk.first.substr(1)] = lnk.first;
 	}
 
 }
@@ -0,0 +1,137 @@
+/****************************************************************
+ * DESTINATIONTREES.CPP
+ *
+ * This file contains all the definitions of the methods of
+ * DestinationTrees.hpp (see this file for methods' documentation)
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+#include "../include/DestinationTrees.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+
+void DestinationTrees::selectDestinations(const Network& network, const vector<unsigned int>& n_trips,
+		                                  unsigned int max_dest, float min_share) {
+
+	_slots.clear();
+	_dest_nodes.clear();
+	_next_link.clear();
+
+	unsigned long total_trips = 0;
+	vector<pair<unsigned int,int>> ranking;                       // (number of trips, node index)
+	for( unsigned int n = 0; n < n_trips.size(); n++ ) {
+		total_trips += n_trips[n];
+		if( n_trips[n] > 0 ) ranking.push_back(make_pair(n_trips[n], (int)n));
+	}
+
+	// most popular destinations first, ties broken by node index for every process to agree
+	sort(ranking.begin(), ranking.end(), [](const pair<unsigned int,int>& a, const pair<unsigned int,int>& b) {
+		return a.first > b.first || ( a.first == b.first && a.second < b.second );
+	});
+
+	for( unsigned int i = 0; i < ranking.size() && _dest_nodes.size() < max_dest; i++ ) {
+
+		if( (float)ranking[i].first < min_share * (float)total_trips ) break;
+
+		_slots[network.getNodeIdByIndex(ranking[i].second)] = (int)_dest_nodes.size();
+		_dest_nodes.push_back(ranking[i].second);
+
+	}
+
+	_next_link.resize(_dest_nodes.size());
+	_dist.resize(_dest_nodes.size());
+
+}
+
+
+void DestinationTrees::computeTrees(const Network& network, const vector<int>& slots, const vector<float>& cost) {
+
+	int n_threads = 1;
+#ifdef _OPENMP
+	n_threads = omp_get_max_threads();
+#endif
+
+	// One tree per thread, or the threads sharing every tree when there are fewer trees than threads
+	if( (int)slots.size() < n_threads ) {
+		for( int s : slots ) network.computeTreeToDestinationDeltaStepping(_dest_nodes[s], cost, _next_link[s], _dist[s]);
+		return;
+	}
+
+#pragma omp parallel for schedule(dynamic, 1)
+	for( int k = 0; k < (int)slots.size(); k++ ) {
+		network.computeTreeToDestination(_dest_nodes[slots[k]], cost, _next_link[slots[k]], _dist[slots[k]]);
+	}
+
+}
+
+
+void DestinationTrees::rebuild(const Network& network, const vector<float>& cost, boost::mpi::communicator& comm) {
+
+	_cost = cost;
+
+	// Rank and size read once, outside of the threads (no MPI call from the threads)
+	int n_proc = comm.size();
+	int proc   = comm.rank();
+
+	// Each process computes its share of the trees (the costs are not changed meanwhile)...
+	vector<int> local;
+	for( int s = proc; s < (int)_dest_nodes.size(); s += n_proc ) local.push_back(s);
+	computeTrees(network, local, cost);
+
+	// ... and sends them to every other process
+	for( unsigned int s = 0; s < _dest_nodes.size(); s++ ) {
+		boost::mpi::broadcast(comm, _next_link[s], (int)s % n_proc);
+	}
+
+}
+
+
+unsigned int DestinationTrees::updateLinks(const Network& network, const vector<int>& links, const vector<float>& cost,
+		                                   boost::mpi::communicator& comm) {
+
+	if( _cost.empty() == true ) return 0;
+
+	int n_proc = comm.size();
+	int proc   = comm.rank();
+
+	// Trees computed locally affected by the change
+	vector<int> dirty(_dest_nodes.size(), 0);
+	for( int l : links ) {
+
+		int start = network.getLinkStartIndex(l);
+		int end   = network.getLinkEndIndex(l);
+
+		for( unsigned int s = 0; s < _dest_nodes.size(); s++ ) {
+			if( (int)s % n_proc != proc ) continue;
+			if( cost[l] > _cost[l] && _next_link[s][start] == l ) dirty[s] = 1;
+			if( cost[l] < _cost[l] && _dist[s][end] < std::numeric_limits<float>::max() && cost[l] + _dist[s][end] < _dist[s][start] ) dirty[s] = 1;
+		}
+
+		_cost[l] = cost[l];
+
+	}
+
+	vector<int> dirty_all(dirty.size(), 0);
+	boost::mpi::all_reduce(comm, dirty.data(), (int)dirty.size(), dirty_all.data(), boost::mpi::maximum<int>());
+
+	// ... recomputed by their process and sent to every other process
+	vector<int> local;
+	for( int s = proc; s < (int)_dest_nodes.size(); s += n_proc ) if( dirty_all[s] == 1 ) local.push_back(s);
+	computeTrees(network, local, _cost);
+
+	unsigned int n_updated = 0;
+	for( unsigned int s = 0; s < _dest_nodes.size(); s++ ) {
+		if( dirty_all[s] == 0 ) continue;
+		boost::mpi::broadcast(comm, _next_link[s], (int)s % n_proc);
+		n_updated++;
+	}
+
+	return n_updated;
+
+}
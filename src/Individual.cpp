@@ -31,12 +31,14 @@ IndividualPackage::IndividualPackage() :
 		size(),
 		cur_trip_duration_theo(),
 		n_path_performed(),
-		n_link_in_path() {
+		n_link_in_path(),
+		on_dest_tree(),
+		fitness() {
 }
 
 IndividualPackage::IndividualPackage(int aId, int aInitProc, int aAgentType, int aCurProc, std::vector<Trip> aTrips, float aX, float aY, float aRemainingTime,
 									 Strategy aStrategy, std::vector<std::string> aPath, bool aEnRoute, bool aAtNode, std::string aCurLink, int aSize, float aCurTripDurationTheo,
-									 int aNPathPerformed, int aLinkInPath) :
+									 int aNPathPerformed, int aLinkInPath, bool aOnDestTree, float aFitness) :
 		id(aId),
 		init_proc(aInitProc),
 		agent_type(aAgentType),
@@ -53,12 +55,14 @@ IndividualPackage::IndividualPackage(int aId, int aInitProc, int aAgentType, int
 		size(aSize),
 		cur_trip_duration_theo(aCurTripDurationTheo),
 		n_path_performed(aNPathPerformed),
-		n_link_in_path(aLinkInPath) {
+		n_link_in_path(aLinkInPath),
+		on_dest_tree(aOnDestTree),
+		fitness(aFitness) {
 }
 
 Individual::Individual(repast::AgentId id, std::vector<Trip> trips, float x, float y, float remaining_time,
 			           Strategy strategy, std::vector<std::string> path, bool en_route, bool at_node, std::string cur_link,
-			           int size, float cur_trip_duration_norm, int n_path_performed, int n_link_in_path) :
+			           int size, float cur_trip_duration_norm, int n_path_performed, int n_link_in_path, bool on_dest_tree, float fitness) :
 		_id(id),
 		_trips(trips),
 		_x(x),
@@ -72,7 +76,9 @@ Individual::Individual(repast::AgentId id, std::vector<Trip> trips, float x, flo
 		_size(size),
 		_cur_trip_duration_theo(cur_trip_duration_norm),
 		_n_path_performed(n_path_performed),
-		_n_link_in_path(n_link_in_path){
+		_n_link_in_path(n_link_in_path),
+		_on_dest_tree(on_dest_tree),
+		_fitness(fitness) {
 }
 
 Individual::Individual(repast::AgentId id, std::vector<Trip> trips, int size) :
@@ -88,7 +94,9 @@ Individual::Individual(repast::AgentId id, std::vector<Trip> trips, int size) :
 		_size(size),
 		_cur_trip_duration_theo(0.0f),
 		_n_path_performed(1),
-		_n_link_in_path(0) {
+		_n_link_in_path(0),
+		_on_dest_tree(false),
+		_fitness(-1.0f) {
 
 	if( this->_trips.size() > 0 ) {
 		this->_remaining_time = this->_trips[0].getStartingTime();
@@ -155,6 +163,15 @@ string Individual::getNextLinkAndRemove() {
 }
 
 
+void Individual::takeLink( const string& linkId ) {
+
+	// the path is not stored, only the current link and number of links traveled are updated
+	_cur_link = linkId;
+	_n_link_in_path++;
+
+}
+
+
 bool Individual::isRerouting( Network & network, float simulation_time ) {
 
 	// Computing inputs of the strategy
@@ -175,15 +192,16 @@ bool Individual::isRerouting( Network & network, float simulation_time ) {
 }
 
 
-void Individual::setNextTrip( Network& network, float time ) {
+void Individual::setNextTrip( Network& network, float time, bool use_dest_tree ) {
 
 	// Removing previous trip
 	this->_trips.erase( this->_trips.begin() );
 
-	// Characterizing new trip
-	std::string origin_node_id      = this->_trips.front().getIdOrigin();
-	std::string destination_node_id = this->_trips.front().getIdDestination();
-	this->_path = network.computePath(origin_node_id, destination_node_id);
+	// Characterizing new trip (no path stored if following a destination tree or computed by the model)
+	std::string origin_node_id = this->_trips.front().getIdOrigin();
+	this->_on_dest_tree = use_dest_tree;
+	if( use_dest_tree == false && this->_trips.front().getPath().empty() == false ) this->_path = this->_trips.front().getPath();   // imported path
+	else                                                                           this->_path.clear();
 
 	// Updating agent position
 	this->_x = network.getNodes().at(origin_node_id).getX();
@@ -0,0 +1,50 @@
+/****************************************************************
+ * LINKCOSTSNAPSHOT.CPP
+ *
+ * This file contains all the definitions of the methods of
+ * LinkCostSnapshot.hpp (see this file for methods' documentation)
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+#include <atomic>
+#include "../include/LinkCostSnapshot.hpp"
+
+using namespace std;
+
+
+LinkCostSnapshot::LinkCostSnapshot() : _back(0), _version(0) {
+
+	_buffers[0] = make_shared<vector<float>>();
+	_buffers[1] = make_shared<vector<float>>();
+	atomic_store(&_published, Snapshot(make_shared<const vector<float>>()));
+
+}
+
+
+vector<float>& LinkCostSnapshot::write() {
+
+	// The back buffer is the snapshot before the published one: no router can acquire it any more,
+	// and once no router holds it (only the buffers own it) it can be overwritten
+	if( _buffers[_back].use_count() > 1 ) _buffers[_back] = make_shared<vector<float>>(*_buffers[_back]);
+	atomic_thread_fence(memory_order_acquire);
+
+	return *_buffers[_back];
+
+}
+
+
+void LinkCostSnapshot::publish() {
+
+	atomic_store(&_published, Snapshot(_buffers[_back]));
+	_back = 1 - _back;
+	_version++;
+
+}
+
+
+LinkCostSnapshot::Snapshot LinkCostSnapshot::read() const {
+
+	return atomic_load(&_published);
+
+}
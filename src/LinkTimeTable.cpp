@@ -0,0 +1,93 @@
+/****************************************************************
+ * LINKTIMETABLE.CPP
+ *
+ * This file contains all the definitions of the methods of
+ * LinkTimeTable.hpp (see this file for methods' documentation)
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "../include/LinkTimeTable.hpp"
+
+using namespace std;
+
+
+uint16_t LinkTimeTable::quantise(float time, float free_flow_time) const {
+
+	if( free_flow_time <= 0.0f || time <= free_flow_time ) return 0;
+
+	// ... saturating at the largest factor, a link that slow being avoided anyway
+	float q = round( ( time / free_flow_time - 1.0f ) / _step );
+
+	return (uint16_t)min(q, (float)numeric_limits<uint16_t>::max());
+
+}
+
+
+void LinkTimeTable::build(int n_links, const vector<int>& owned, float step) {
+
+	_step  = step;
+	_owned = owned;
+	sort(_owned.begin(), _owned.end());                                  // increasing, for the index deltas sent
+	_factor.assign(n_links, 0);
+
+}
+
+
+unsigned int LinkTimeTable::update(const vector<float>& free_flow, const vector<float>& times,
+		                           boost::mpi::communicator& comm) {
+
+	// Only the factors changed since the previous epoch are sent, every change packed as the
+	// difference to the previous link index (varint, 7 bits per byte) and the factor (2 bytes)
+	vector<unsigned char> changes;
+	int prev = 0;
+	for( int l : _owned ) {
+		uint16_t f = quantise(times[l], free_flow[l]);
+		if( f == _factor[l] ) continue;
+		unsigned int delta = (unsigned int)( l - prev );
+		while( delta >= 0x80 ) {
+			changes.push_back((unsigned char)( ( delta & 0x7f ) | 0x80 ));
+			delta >>= 7;
+		}
+		changes.push_back((unsigned char)delta);
+		changes.push_back((unsigned char)( f & 0xff ));
+		changes.push_back((unsigned char)( f >> 8 ));
+		prev = l;
+		_n_sent++;
+	}
+
+	vector<vector<unsigned char>> changes_gather;
+	boost::mpi::all_gather(comm, changes, changes_gather);
+
+	_changed.clear();
+	for( const auto& c : changes_gather ) {
+		int l = 0;
+		unsigned int i = 0;
+		while( i < c.size() ) {
+			unsigned int delta = 0;
+			for( int shift = 0; ; shift += 7 ) {
+				delta |= (unsigned int)( c[i] & 0x7f ) << shift;
+				if( ( c[i++] & 0x80 ) == 0 ) break;
+			}
+			l += (int)delta;
+			_factor[l] = (uint16_t)( c[i] | ( c[i + 1] << 8 ) );
+			i += 2;
+			_changed.push_back(l);
+		}
+	}
+	_n_epochs++;
+
+	return getNChanged();
+
+}
+
+
+void LinkTimeTable::getTimes(const vector<float>& free_flow, vector<float>& times) const {
+
+	times.resize(_factor.size());
+	for( unsigned int l = 0; l < _factor.size(); l++ ) times[l] = getTime(l, free_flow[l]);
+
+}
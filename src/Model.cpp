@@ -15,7 +15,10 @@ using namespace std;
 using namespace tinyxml2;
 
 
-Model::Model( boost::mpi::communicator* world, Properties & props ) : _props(props), _time(0.0f) {
+Model::Model( boost::mpi::communicator* world, Properties & props ) : _props(props), _time(0.0f), _pin_threads(false), _reorder_interval(0), _step_stats(false),
+		                                                                _n_agents_stepped(0), _n_link_switches(0), _dest_trees_interval(0),
+		                                                                _route_tasks_interval(0), _use_route_cache(false), _link_times_interval(0),
+		                                                                _start_time(0.0f), _end_time(std::numeric_limits<float>::max()), _positions_interval(0) {
 
 	// Reading properties, rank of the process and input filenames ----
 
@@ -23,11 +26,42 @@ Model::Model( boost::mpi::communicator* world, Properties & props ) : _props(pro
 	agents = new SharedContext<Individual>(world);
 	_time_tolerance = boost::lexical_cast<float>(_props.getProperty("par.time_tolerance"));
 
+	// Simulated time window (whole day by default) --------------------
+
+	if( _props.contains("par.start_time") ) _start_time = boost::lexical_cast<float>(_props.getProperty("par.start_time"));
+	if( _props.contains("par.end_time") && boost::lexical_cast<float>(_props.getProperty("par.end_time")) > 0.0f ) {
+		_end_time = boost::lexical_cast<float>(_props.getProperty("par.end_time"));
+	}
+	if( _end_time <= _start_time ) {
+		cerr << "ERROR: the end of the time window must be after its beginning" << endl;
+		throw "Error in the time window";
+	}
+	_time = _start_time;
+
+	// Threads pinned to the cores of the process, large arrays on huge pages
+
+	if( _props.contains("par.huge_pages") && _props.getProperty("par.huge_pages").compare("y") == 0 ) Placement::setHugePages(true);
+	_pin_threads = _props.contains("par.pin_threads") && _props.getProperty("par.pin_threads").compare("y") == 0;
+	if( _pin_threads == true ) {
+		if( Placement::pinThreads() == true ) cout << "INFO: Proc " << _proc << ": threads pinned (thread:core/node) " << Placement::describeThreads() << endl;
+		else                                  cout << "WARNING: Proc " << _proc << ": threads cannot be pinned, their memory is not placed" << endl;
+	}
+
+
 	// Model space initialization -------------------------------------
 
 	_network = Data::getInstance()->getNetwork();
 	//_network.shuffleNodesCoordinates();
 
+	// Agents decomposition: every process holds the whole network and keeps its agents
+
+	_decomposition = Decomposition::SPATIAL;
+	if( _props.contains("par.decomposition") && _props.getProperty("par.decomposition").compare("agents") == 0 ) {
+		if( _network.getPartition() < 0 ) _decomposition = Decomposition::AGENTS;
+		else if( _proc == 0 ) cout << "WARNING: the agents decomposition requires the whole network, using the spatial one" << endl;
+	}
+	_n_trips_proc.assign(world->size(), 0);
+
 	//Point<double> origin(_network.getMinX() - 1.0, _network.getMinY() - 1.0);
 	//Point<double> extent(_network.getMaxX() - _network.getMinX() + 1.0, _network.getMaxY() - _network.getMinY() + 1.0);
 
@@ -56,14 +90,14 @@ Model::Model( boost::mpi::communicator* world, Properties & props ) : _props(pro
 	
 	// Model agents initialization ------------------------------------
 	
-	unsigned int n_trips = 0;
+	unsigned int n_trips = init_warm_start();
 	if (this->_props.getProperty("par.network_format").compare("matsim") == 0 ) {
 	  cout << "INFO: Proc " << _proc << " starts init trips (MATSIM format)" << endl;
-		n_trips = init_matsim();
+		n_trips += init_matsim();
 	}
 	else {
 	  cout << "INFO: Proc " << _proc << " start init trips (TRANSIMS format)" << endl;
-		n_trips = init_transims();
+		n_trips += init_transims();
 	}
 	cout << "INFO: Proc " << _proc << " done init trips" << endl;
 
@@ -72,8 +106,48 @@ Model::Model( boost::mpi::communicator* world, Properties & props ) : _props(pro
 	boost::mpi::all_reduce(*RepastProcess::instance()->getCommunicator(), this->agents->size(), n_agents_total, std::plus<int>());
 	_props.putProperty("number.agents",n_agents_total);
 
+	// Network contraction or partition overlay ---------------------
+
+	if( _network.getPartition() >= 0 ) {
+		if( _proc == 0 && ( _props.getProperty("par.contract_chains").compare("y") == 0 || ( _props.contains("par.dest_trees_max") && _props.getProperty("par.dest_trees_max").compare("0") != 0 ) ) ) {
+			cout << "WARNING: chains contraction and destination trees are disabled with a sharded network" << endl;
+		}
+		init_overlay();
+	}
+	else {
+		if( _props.getProperty("par.contract_chains").compare("y") == 0 ) contract_network();
+		init_destination_trees();
+	}
+
+	// ... the network index being final, interleaved over the nodes of the threads reading it
+	if( _pin_threads == true ) {
+		std::string pages = _network.placeIndex();
+		if( pages.empty() == false ) cout << "INFO: Proc " << _proc << ": network index pages " << pages << ( Placement::hasHugePages() == true ? " (huge pages advised)" : "" ) << endl;
+	}
+
+	init_network_events();
+	init_link_times();
+
 	// Agents initial paths and strategies ------------------------
 
+	if( _props.contains("par.route_tasks_interval") ) _route_tasks_interval = boost::lexical_cast<unsigned int>(_props.getProperty("par.route_tasks_interval"));
+	if( _props.contains("par.route_tasks_chunk") )    _route_tasks.setChunk(boost::lexical_cast<int>(_props.getProperty("par.route_tasks_chunk")));
+	if( _network.getPartition() >= 0 ) _route_tasks_interval = 0;
+	if( _route_tasks_interval > 0 && _props.contains("par.route_cache") && _props.getProperty("par.route_cache").compare("y") == 0 ) {
+		_use_route_cache = true;
+		unsigned int shard_size = 100000, near_size = 10000;
+		if( _props.contains("par.route_cache_size") ) shard_size = boost::lexical_cast<unsigned int>(_props.getProperty("par.route_cache_size"));
+		if( _props.contains("par.route_cache_near") ) near_size  = boost::lexical_cast<unsigned int>(_props.getProperty("par.route_cache_near"));
+		_route_cache.setCapacity(shard_size, near_size);
+	}
+
+	// Log of the routing requests, replayed by bench_routes, the initial paths included
+
+	if( _props.contains("par.route_log") && _props.getProperty("par.route_log").compare("y") == 0 ) {
+		string filename = "../output/routes_proc_" + to_string(_proc) + ".bin";
+		if( _route_log.open(filename, _network) == false ) cerr << "Could not open " << filename << endl;
+	}
+
 	compute_initial_paths();
 	init_agents_strategies();
 
@@ -87,6 +161,38 @@ Model::Model( boost::mpi::communicator* world, Properties & props ) : _props(pro
 
 	if( _proc == 0 ) cout << "Number of records : aggregate : " << n_records << " - snapshots : " << n_records_snapshot << endl;
 
+	// Vehicles positions stream, every process writing its vehicles and its links index
+
+	if( _props.contains("par.positions_interval") ) _positions_interval = boost::lexical_cast<unsigned int>(_props.getProperty("par.positions_interval"));
+	if( _positions_interval > 0 ) {
+		string basename = "../output/positions_proc_" + to_string(_proc);
+		if( _positions.open(basename) == false ) {
+			cerr << "Could not open " << basename << ".bin" << endl;
+			_positions_interval = 0;
+		}
+		else {
+			// ... the links of the input network, a super link being replaced by its original links
+			ofstream file_links( (basename + "_links.csv").c_str(), ios::out );
+			file_links << "INDEX;LINK" << endl;
+			for( int l = 0; l < _network.getNLinksIndexed(); l++ ) {
+				for( const auto& o : _network.getOriginalLinks(_network.getLinkIdByIndex(l)) ) {
+					int index = (int)_positions_links.size();
+					_positions_links[o] = index;
+					file_links << index << ";" << o << endl;
+				}
+			}
+			file_links.close();
+		}
+	}
+
+	// Agents stepped by current link, and measures of the locality of their updates
+
+	if( _props.contains("par.reorder_agents_interval") ) _reorder_interval = boost::lexical_cast<unsigned int>(_props.getProperty("par.reorder_agents_interval"));
+	if( _props.contains("par.step_stats") && _props.getProperty("par.step_stats").compare("y") == 0 ) {
+		_step_stats = true;
+		if( _step_misses.open() == false && _proc == 0 ) cout << "WARNING: cache misses counter unavailable, only the links switches are measured" << endl;
+	}
+
 	// Trips starting time recording ----------------------------------
 
 	this->_trips_starting_time.reserve(n_trips);
@@ -96,9 +202,9 @@ Model::Model( boost::mpi::communicator* world, Properties & props ) : _props(pro
 	for( auto lnk : _network.getLinks() ) {
 
 		Node lnk_orig_node = _network.getNodes().at(lnk.second.getStartNodeId());
-		if( isInLocalBounds( lnk_orig_node.getX(), lnk_orig_node.getY() ) == true ) {
+		if( _decomposition == Decomposition::AGENTS || isInLocalBounds( lnk_orig_node.getX(), lnk_orig_node.getY() ) == true ) {
 			_links_load_over_time[lnk.first] = vector<int>(n_records);
-			_links_state_snapshot[lnk.first] = vector<int>(n_records_snapshot);
+			for( const auto& orig : _network.getOriginalLinks(lnk.first) ) _links_state_snapshot[orig] = vector<int>(n_records_snapshot);
 		}
 
 	}
@@ -138,17 +244,115 @@ Model::~Model() {
 	delete agents;
 }
 
+unsigned int Model::init_warm_start() {
+
+	if( _props.contains("file.warm_start") == false || _props.getProperty("file.warm_start").empty() == true ) return 0;
+
+	if( this->_proc == 0 ) cout << "... initialization agents on the road (warm start) !" << endl;
+
+	unsigned int n_trips   = 0;
+	unsigned int n_ignored = 0;
+
+	string filename = this->_props.getProperty("file.warm_start");
+	ifstream file(filename.c_str(), ios::in);
+	string a_line;
+
+	if (file) {
+
+		getline(file, a_line);                                              // skipping header line
+		while (getline(file, a_line)) {
+
+			// extracting data: id, link, remaining time on the link and (origin, destination, starting time) of every trip
+			auto data = split<string>(a_line, ";");
+			if( data.size() < 6 ) continue;
+
+			int    id             = boost::lexical_cast<int>(data[0]);
+			string link_id        = data[1];
+			float  remaining_time = boost::lexical_cast<float>(data[2]);
+
+			vector<Trip> trips;
+			for( unsigned int i = 3; i + 2 < data.size(); i += 3 ) {
+				trips.push_back(Trip(data[i], data[i + 1], boost::lexical_cast<float>(data[i + 2])));
+			}
+
+			// link unknown (or, with a sharded network, not starting in the local partition), the agent ignored being
+			// loaded from the trips file
+			if( _network.getLinks().count(link_id) == 0 ) {
+				if( _network.getPartition() < 0 ) ++n_ignored;
+				else                              _warm_agents.insert(id);
+				continue;
+			}
+			_warm_agents.insert(id);
+
+			// the current trip is resumed from the end of the link, the agent belonging to the process of its start
+			const Link& lnk = _network.getLinks().at(link_id);
+			trips[0] = Trip(lnk.getEndNodeId(), trips[0].getIdDestination(), trips[0].getStartingTime());
+
+			if( isLocalAgent(lnk.getStartNodeId(), (unsigned int)trips.size()) == true ) {
+
+				AgentId agent_id_repast(id, this->_proc, MODEL_AGENT_IND_TYPE, this->_proc);
+				Individual * newAgent = new Individual(agent_id_repast, trips);
+				newAgent->setEnRoute(true);
+				newAgent->setAtNode(false);
+				newAgent->setCurLink(link_id);
+				newAgent->setRemainingTime(remaining_time);
+				agents->addAgent(newAgent);
+				n_trips += trips.size();
+
+			}
+
+		}
+
+		file.close();
+
+	} else {
+		cerr << "Could not open " << filename << endl;
+		throw "Error opening warm start file";
+	}
+
+	if( _proc == 0 && n_ignored > 0 ) cout << "WARNING: " << n_ignored << " agents of the warm start on unknown links ignored" << endl;
+
+	return n_trips;
+
+}
+
+
+Individual* Model::getWarmAgent(int id) {
+
+	AgentId agent_id_repast(id, this->_proc, MODEL_AGENT_IND_TYPE, this->_proc);
+	if( _warm_agents.count(id) == 0 || agents->contains(agent_id_repast) == false ) return NULL;
+
+	return agents->getAgent(agent_id_repast);
+
+}
+
+
+void Model::appendWarmTrips(int id, const std::vector<Trip>& trips) {
+
+	Individual* agent = getWarmAgent(id);
+	if( agent == NULL ) return;
+
+	for( const auto& t : trips ) agent->addTrip(t);
+
+}
+
+
 unsigned int Model::init_transims() {
 
 	if( this->_proc == 0 ) cout << "... initialization agents (from transims input format) !" << endl;
 
 	unsigned int n_trips = 0;
-	int cur_agent_id = 1;
+	unsigned int n_unroutable = 0;
+	int agent_index = 0;                                                    // dense index of the current agent, the same on every process
+	ofstream file_ids;                                                      // agents index of every person (process 0)
+	if( this->_proc == 0 ) {
+		file_ids.open("../output/agents_ids.csv", ios::out);
+		file_ids << "AGENT_ID;PERSON_ID" << endl;
+	}
 
 
 	// Network configuration
 
-	Network net = Data::getInstance()->getNetwork();
 	/*
 	double proc_min_x = continuous_space->bounds().origin().getX();
 	double proc_max_x = proc_min_x + continuous_space->bounds().extents().getX();
@@ -187,12 +391,11 @@ unsigned int Model::init_transims() {
 			auto agent_hh_id     = boost::lexical_cast<int>(data[0]);
 			auto agent_id        = boost::lexical_cast<int>(data[1]);
 
-			cur_agent_id = agent_hh_id * 100 + agent_id;
-
 			// initial agent id
 			if ( prev_agent_id == -42 ) {
 				prev_agent_id = agent_id;
 				prev_agent_hh_id = agent_hh_id;
+				if( this->_proc == 0 ) file_ids << agent_index << ";" << agent_hh_id << "_" << agent_id << endl;
 			}
 
 			// finding origin and destination node
@@ -210,10 +413,14 @@ unsigned int Model::init_transims() {
 					if( start_time_trip < end_time_previous_trip ) curTrip.setStartingTime(end_time_previous_trip);
 				}
 
-				// ... checking if agent actually moves and its mode is car or taxi
-				if( orig_trip != dest_trip && ( mode_trip == static_cast<int>(Mode_transims::CAR_DRIVER) || mode_trip == static_cast<int>(Mode_transims::TAXI) ) ) {
-					trips.push_back(curTrip);
-					++n_trips;
+				// ... checking if agent actually moves during the time window and its mode is car or taxi
+				if( orig_trip != dest_trip && isInTimeWindow(curTrip.getStartingTime()) == true
+						&& ( mode_trip == static_cast<int>(Mode_transims::CAR_DRIVER) || mode_trip == static_cast<int>(Mode_transims::TAXI) ) ) {
+					if( isRoutable(orig_trip, dest_trip) == true ) {
+						trips.push_back(curTrip);
+						++n_trips;
+					}
+					else ++n_unroutable;
 				}
 
 				// ... updating previous trip end time
@@ -226,12 +433,15 @@ unsigned int Model::init_transims() {
 				// checking if agent is actually traveling
 				if( trips.size() > 0 ) {
 
+					// trips of a warm-started agent following the ones of the warm start
+					if( _warm_agents.count(agent_index) == 1 ) {
+						appendWarmTrips(agent_index, trips);
+					}
 					// checking if agent belongs to current process
-					if( isInLocalBounds( net.getNodes().at(trips[0].getIdOrigin()).getX(), net.getNodes().at(trips[0].getIdOrigin()).getY()) ) {
+					else if( isLocalAgent(trips[0].getIdOrigin(), (unsigned int)trips.size()) == true ) {
 
 						// previous agent generation
-						//cur_agent_id++;
-						AgentId agent_id_repast(cur_agent_id, this->_proc, MODEL_AGENT_IND_TYPE, this->_proc);
+						AgentId agent_id_repast(agent_index, this->_proc, MODEL_AGENT_IND_TYPE, this->_proc);
 						Individual * newAgent = new Individual(agent_id_repast, trips);
 						agents->addAgent(newAgent);
 
@@ -240,15 +450,20 @@ unsigned int Model::init_transims() {
 				}
 
 				// new agent's trips initialization
+				agent_index++;                                                               // new agent index
+				if( this->_proc == 0 ) file_ids << agent_index << ";" << agent_hh_id << "_" << agent_id << endl;
 				trips.clear();                                                               // reseting trips
 				prev_agent_id    = agent_id;                                                 // new agent id
 				prev_agent_hh_id = agent_hh_id;                                              // new agent household id
-				if( orig_trip != dest_trip
+				if( orig_trip != dest_trip && isInTimeWindow(curTrip.getStartingTime()) == true
 						&& ( mode_trip == static_cast<int>(Mode_transims::CAR_DRIVER)
 								|| mode_trip == static_cast<int>(Mode_transims::TAXI) ) ) {
 
-					trips.push_back(curTrip);                                                // first trip of the new agent
-					++n_trips;
+					if( isRoutable(orig_trip, dest_trip) == true ) {
+						trips.push_back(curTrip);                                            // first trip of the new agent
+						++n_trips;
+					}
+					else ++n_unroutable;
 
 				}
 
@@ -263,10 +478,12 @@ unsigned int Model::init_transims() {
 
 		// Adding the last agent to the context of the right process
 		if( trips.size() > 0 ) {
-			if( isInLocalBounds(net.getNodes().at(trips[0].getIdOrigin()).getX(), net.getNodes().at(trips[0].getIdOrigin()).getY() ) == true ) {
+			if( _warm_agents.count(agent_index) == 1 ) {
+				appendWarmTrips(agent_index, trips);
+			}
+			else if( isLocalAgent(trips[0].getIdOrigin(), (unsigned int)trips.size()) == true ) {
 
-				//cur_agent_id++;
-				AgentId agent_id_repast(cur_agent_id, this->_proc, MODEL_AGENT_IND_TYPE, this->_proc);                // adding last agent
+				AgentId agent_id_repast(agent_index, this->_proc, MODEL_AGENT_IND_TYPE, this->_proc);                 // adding last agent
 				Individual * newAgent = new Individual(agent_id_repast, trips);
 				agents->addAgent(newAgent);
 
@@ -280,6 +497,8 @@ unsigned int Model::init_transims() {
 		throw "Error opening transims input file";
 	}
 
+	if( _proc == 0 && n_unroutable > 0 ) cout << "WARNING: " << n_unroutable << " trips between unconnected nodes ignored" << endl;
+
 	return n_trips;
 
 }
@@ -287,17 +506,28 @@ unsigned int Model::init_transims() {
 
 unsigned int Model::init_matsim() {
 
-	std::hash<std::string> hasher;
-
 	if( this->_proc == 0 ) cout << "... initialization agents (from MATSim input format) !" << endl;
 
 	unsigned n_trips = 0;
+	unsigned n_routes_imported = 0;
+	unsigned n_routes_rejected = 0;
+	unsigned n_unroutable = 0;
+	int      agent_index = 0;                                      // dense index of the next agent, the same on every process
+	ofstream file_ids;                                             // agents index of every person (process 0)
+	if( this->_proc == 0 ) {
+		file_ids.open("../output/agents_ids.csv", ios::out);
+		file_ids << "AGENT_ID;PERSON_ID" << endl;
+	}
 
 	// Loading XML file containing the network data.
 	string filename = this->_props.getProperty("file.trips_matsim");
 	XMLDocument doc(filename.c_str());
 	doc.loadFile(filename.c_str());
 
+	// Locating the activities without node ---------------------------------
+
+	snap_matsim_activities(doc);
+
 	// Loop on the individuals
 	XMLElement * ele = doc.FirstChildElement("plans")->FirstChildElement("person");
 	while (ele) {
@@ -306,7 +536,8 @@ unsigned int Model::init_matsim() {
 		bool add_agent = true;
 		const XMLAttribute * attr = ele->FirstAttribute();
 		std::string id_str = attr->StringValue();
-		int id = (int)hasher(id_str);
+		int id = agent_index++;
+		if( this->_proc == 0 ) file_ids << id << ";" << id_str << endl;
 
 		vector<Trip> trips;
 
@@ -322,15 +553,26 @@ unsigned int Model::init_matsim() {
 		float  act_end_time_prev = timeToSec(act_end_time_str);
 		string house_node_id     = act_node_id_start;
 
-		double house_x = _network.getNodes().at(house_node_id).getX();
-		double house_y = _network.getNodes().at(house_node_id).getY();
-
-		//cout << "House id " << house_node_id << " at coordinates (" << house_x << "," << house_y << ")" << endl;
 		//cout << " => original coordinates house id " << house_node_id << " at coordinates (" << _network.getNodes().at(house_node_id).getXData() << "," << _network.getNodes().at(house_node_id).getYData() << ")" << endl;
 
-		if( isInLocalBounds(house_x, house_y) == true ) {
+		// trips in the time window: one between every two consecutive activities, leaving at the end of the first one
+		unsigned int n_trips_window = 0;
+		string       first_node_id;
+		for( XMLElement * e = ele_act; e->NextSiblingElement("act") != NULL; e = e->NextSiblingElement("act") ) {
+			string node_id      = e->StringAttribute("node_id");
+			string node_id_next = e->NextSiblingElement("act")->StringAttribute("node_id");
+			if( isInTimeWindow(timeToSec(e->StringAttribute("end_time"))) == true && node_id != node_id_next && isRoutable(node_id, node_id_next) == true ) {
+				if( n_trips_window == 0 ) first_node_id = node_id;
+				n_trips_window++;
+			}
+		}
+
+		// ... a warm-started agent getting its trips of the window after the ones of the warm start
+		bool is_warm = _warm_agents.count(id) == 1;
+		if( n_trips_window > 0 && ( is_warm == true ? getWarmAgent(id) != NULL : isLocalAgent(first_node_id, n_trips_window) ) ) {
 
 			// Loop on the current individual remaining activities-----------------
+			XMLElement * ele_act_prev = ele_act;
 			ele_act = ele_act->NextSiblingElement("act");
 			while ( ele_act->NextSiblingElement("act") ) {
 
@@ -340,9 +582,16 @@ unsigned int Model::init_matsim() {
 
 				// construct trip and pushing it to the set of trip performed by the individual
 				if( act_node_id_start != act_node_id_dest ) {
-					Trip cur_trip(act_node_id_start, act_node_id_dest, act_end_time_prev);
-					trips.push_back(cur_trip);
-					++n_trips;
+					if( isInTimeWindow(act_end_time_prev) == true && isRoutable(act_node_id_start, act_node_id_dest) == false ) {
+						++n_unroutable;
+					}
+					else if( isInTimeWindow(act_end_time_prev) == true ) {
+						Trip cur_trip(act_node_id_start, act_node_id_dest, act_end_time_prev);
+						if( read_matsim_route(ele_act_prev->NextSiblingElement("leg"), cur_trip) == false ) ++n_routes_rejected;
+						if( cur_trip.getPath().empty() == false ) ++n_routes_imported;
+						trips.push_back(cur_trip);
+						++n_trips;
+					}
 				}
 				else {
 					add_agent = false;
@@ -357,16 +606,25 @@ unsigned int Model::init_matsim() {
 				act_node_id_start = act_node_id_dest;
 
 				// next activity
+				ele_act_prev = ele_act;
 				ele_act = ele_act->NextSiblingElement("act");
 
 			}
 
-			// Last trip: return to home ------------------------------------------
+			// Last trip: to the last activity, usually at home -------------------
 
-			Trip trip_to_home(act_node_id_start,house_node_id,act_end_time_prev);
-			if( act_node_id_start != house_node_id ) {
-				trips.push_back(trip_to_home);
-				++n_trips;
+			string last_node_id = ele_act->StringAttribute("node_id");
+			Trip trip_to_home(act_node_id_start,last_node_id,act_end_time_prev);
+			if( act_node_id_start != last_node_id ) {
+				if( isInTimeWindow(act_end_time_prev) == true && isRoutable(act_node_id_start, last_node_id) == false ) {
+					++n_unroutable;
+				}
+				else if( isInTimeWindow(act_end_time_prev) == true ) {
+					if( read_matsim_route(ele_act_prev->NextSiblingElement("leg"), trip_to_home) == false ) ++n_routes_rejected;
+					if( trip_to_home.getPath().empty() == false ) ++n_routes_imported;
+					trips.push_back(trip_to_home);
+					++n_trips;
+				}
 			}
 			else {
 
@@ -375,7 +633,10 @@ unsigned int Model::init_matsim() {
 			}
 
 			// Agent generation ---------------------------------------------------
-			if(add_agent) {
+			if( add_agent && trips.empty() == false && is_warm == true ) {
+				appendWarmTrips(id, trips);
+			}
+			else if( add_agent && trips.empty() == false ) {
 				AgentId agent_id_repast(id, this->_proc, MODEL_AGENT_IND_TYPE, this->_proc);
 				Individual * newAgent = new Individual(agent_id_repast, trips);
 				agents->addAgent(newAgent);
@@ -387,21 +648,272 @@ unsigned int Model::init_matsim() {
 
 	}
 
+	if( n_routes_imported > 0 || n_routes_rejected > 0 ) {
+		cout << "INFO: Proc " << _proc << " imported " << n_routes_imported << " routes (" << n_routes_rejected << " invalid routes ignored)" << endl;
+	}
+	if( n_unroutable > 0 ) cout << "WARNING: Proc " << _proc << " ignored " << n_unroutable << " trips between unconnected nodes" << endl;
+
 	return n_trips;
 
 }
 
 
+bool Model::read_matsim_route(XMLElement * ele_leg, Trip& trip) {
+
+	// No route, or partial paths only with a sharded network
+	if( ele_leg == NULL || _network.getPartition() >= 0 ) return true;
+	XMLElement * ele_route = ele_leg->FirstChildElement("route");
+	if( ele_route == NULL || ele_route->getText() == NULL ) return true;
+
+	vector<std::string> items = split<std::string>(ele_route->getText(), " \t\r\n");
+	vector<std::string> links;
+
+	if( ele_route->StringAttribute("type").compare("links") == 0 ) {
+
+		// links sequence, starting with the link of the origin activity which ends at the origin node
+		unsigned int first = 0;
+		while( first < items.size() && _network.getLinks().count(items[first]) == 1
+				&& _network.getLinks().at(items[first]).getStartNodeId() != trip.getIdOrigin() ) first++;
+		links.assign(items.begin() + first, items.end());
+
+	}
+	else {
+
+		// nodes sequence, the origin and destination nodes being usually omitted
+		if( items.empty() == true || items.front() != trip.getIdOrigin() )    items.insert(items.begin(), trip.getIdOrigin());
+		if( items.back() != trip.getIdDestination() )                        items.push_back(trip.getIdDestination());
+
+		for( unsigned int i = 0; i + 1 < items.size(); i++ ) {
+			if( _network.getNodes().count(items[i]) == 0 || _network.getNodes().count(items[i + 1]) == 0 ) return false;
+			int l = _network.getLinkBetween(_network.getNodeIndex(items[i]), _network.getNodeIndex(items[i + 1]));
+			if( l < 0 ) return false;
+			links.push_back(_network.getLinkIdByIndex(l));
+		}
+
+	}
+
+	// Paths are stored from the last link to the first one
+	vector<std::string> path(links.rbegin(), links.rend());
+	if( _network.isValidPath(path, trip.getIdOrigin(), trip.getIdDestination()) == false ) return false;
+
+	trip.setPath(path);
+	return true;
+
+}
+
+
+void Model::snap_matsim_activities(XMLDocument& doc) {
+
+	// Activities located by a link or by coordinates only
+	vector<XMLElement*> acts;
+	vector<std::string> links;
+	vector<double>      xs, ys;
+	vector<char>        has_xy;
+
+	XMLElement * ele = doc.FirstChildElement("plans")->FirstChildElement("person");
+	while (ele) {
+		XMLElement * ele_act = ele->FirstChildElement("plan")->FirstChildElement("act");
+		while (ele_act) {
+			if( ele_act->attribute("node_id") == NULL ) {
+				acts.push_back(ele_act);
+				links.push_back(ele_act->StringAttribute("link"));
+				xs.push_back(ele_act->DoubleAttribute("x"));
+				ys.push_back(ele_act->DoubleAttribute("y"));
+				has_xy.push_back(ele_act->attribute("x") != NULL && ele_act->attribute("y") != NULL);
+			}
+			ele_act = ele_act->NextSiblingElement("act");
+		}
+		ele = ele->NextSiblingElement("person");
+	}
+
+	if( acts.empty() == true ) return;
+
+	// ... a sharded network only holding its partition, the nodes of the whole network file being indexed for the snapping only
+	NodeLocator shard_locator;
+	if( Data::getInstance()->isSharded() == true ) Data::getInstance()->read_node_locator(shard_locator);
+	const NodeLocator& locator = Data::getInstance()->isSharded() == true ? shard_locator : Data::getInstance()->getNodeLocator();
+
+	// ... located at the end of their link if known, at the nearest node otherwise
+	vector<std::string> nodes(acts.size());
+
+#pragma omp parallel for schedule(dynamic, 1024)
+	for( long a = 0; a < (long)acts.size(); a++ ) {
+		if( links[a].empty() == false )                     nodes[a] = locator.linkEndNode(links[a]);
+		if( nodes[a].empty() == true && has_xy[a] == true ) nodes[a] = locator.nearestNode(xs[a], ys[a]);
+	}
+
+	// ... the activities with neither a known link nor coordinates keep no node, their trips being rejected as unroutable
+	unsigned int n_unlocated = 0;
+	for( unsigned int a = 0; a < acts.size(); a++ ) {
+		if( nodes[a].empty() == true ) n_unlocated++;
+		else                           acts[a]->SetAttribute("node_id", nodes[a].c_str());
+	}
+
+	if( _proc == 0 ) {
+		cout << "... " << acts.size() - n_unlocated << " activities located on the network" << endl;
+		if( n_unlocated > 0 ) cout << "WARNING: " << n_unlocated << " activities with an unknown link and no coordinates, their trips are ignored" << endl;
+	}
+
+}
+
+
+void Model::contract_network() {
+
+	boost::mpi::communicator* comm = RepastProcess::instance()->getCommunicator();
+
+	// Trips origins and destinations of every process must be kept
+	vector<int> protected_local(_network.getNNodesIndexed(), 0);
+	vector<int> protected_total(_network.getNNodesIndexed(), 0);
+
+	auto it_cur = (*agents).localBegin();
+	while ( it_cur != (*agents).localEnd() ) {
+		for( const auto& t : (*it_cur)->getTrips() ) {
+			protected_local[_network.getNodeIndex(t.getIdOrigin())]      = 1;
+			protected_local[_network.getNodeIndex(t.getIdDestination())] = 1;
+		}
+		// ... and the link of the agents already on the road
+		if( (*it_cur)->isEnRoute() == true ) {
+			protected_local[_network.getNodeIndex(_network.getLinks().at((*it_cur)->getCurLink()).getStartNodeId())] = 1;
+		}
+		it_cur++;
+	}
+
+	boost::mpi::all_reduce(*comm, protected_local.data(), (int)protected_local.size(), protected_total.data(), boost::mpi::maximum<int>());
+
+	vector<bool> protected_nodes(protected_total.begin(), protected_total.end());
+	unsigned int n_links_before = _network.getNLinksIndexed();
+	unsigned int n_removed = _network.contractChains(protected_nodes);
+	_network.buildIndex();
+
+	// Imported paths follow the super links of the chains they go through, the ones leaving a chain part-way being computed again
+	it_cur = (*agents).localBegin();
+	while ( it_cur != (*agents).localEnd() ) {
+		vector<Trip> trips = (*it_cur)->getTrips();
+		bool modified = false;
+		for( auto& t : trips ) {
+			if( t.getPath().empty() == true ) continue;
+			vector<std::string> path;
+			if( _network.contractPath(t.getPath(), path) == false || _network.isValidPath(path, t.getIdOrigin(), t.getIdDestination()) == false ) {
+				path.clear();
+			}
+			if( path != t.getPath() ) {
+				t.setPath(path);
+				modified = true;
+			}
+		}
+		if( modified == true ) (*it_cur)->setTrips(trips);
+		it_cur++;
+	}
+
+	if( _proc == 0 ) {
+		cout << "Network contraction: " << n_removed << " nodes removed, " << n_links_before << " links replaced by "
+			 << _network.getNLinksIndexed() << endl;
+	}
+
+}
+
+
+void Model::init_destination_trees() {
+
+	boost::mpi::communicator* comm = RepastProcess::instance()->getCommunicator();
+
+	unsigned int max_dest  = 0;
+	float        min_share = 0.0f;
+	if( _props.contains("par.dest_trees_max") )       max_dest  = boost::lexical_cast<unsigned int>(_props.getProperty("par.dest_trees_max"));
+	if( _props.contains("par.dest_trees_min_share") ) min_share = boost::lexical_cast<float>(_props.getProperty("par.dest_trees_min_share"));
+	if( _props.contains("par.dest_trees_interval") )  _dest_trees_interval = boost::lexical_cast<unsigned int>(_props.getProperty("par.dest_trees_interval"));
+
+	if( max_dest == 0 ) return;
+
+	// Counting the trips ending at every node across every process
+
+	vector<unsigned int> n_trips_local(_network.getNNodesIndexed(), 0);
+	vector<unsigned int> n_trips_total(_network.getNNodesIndexed(), 0);
+
+	auto it_cur = (*agents).localBegin();
+	while ( it_cur != (*agents).localEnd() ) {
+		for( const auto& t : (*it_cur)->getTrips() ) n_trips_local[_network.getNodeIndex(t.getIdDestination())]++;
+		it_cur++;
+	}
+
+	boost::mpi::all_reduce(*comm, n_trips_local.data(), (int)n_trips_local.size(), n_trips_total.data(), std::plus<unsigned int>());
+
+	// Selecting the hot destinations and building their trees at free flow
+
+	_dest_trees.selectDestinations(_network, n_trips_total, max_dest, min_share);
+	_dest_trees.rebuild(_network, _network.getLinksTime(), *comm);
+
+	if( _proc == 0 ) cout << "Destination trees: " << _dest_trees.size() << " hot destinations" << endl;
+
+}
+
+
+void Model::init_overlay() {
+
+	boost::mpi::communicator* comm = RepastProcess::instance()->getCommunicator();
+
+	cout << "INFO: Proc " << _proc << " stores " << _network.getNodes().size() << " nodes and "
+		 << _network.getLinks().size() << " links of the network" << endl;
+
+	// Destinations of the local agents, completed by the processes owning them
+	set<std::string> destinations;
+	auto it_cur = (*agents).localBegin();
+	while ( it_cur != (*agents).localEnd() ) {
+		for( const auto& t : (*it_cur)->getTrips() ) destinations.insert(t.getIdDestination());
+		it_cur++;
+	}
+
+	_overlay.build(_network, *comm);
+	_overlay.completeDestinations(_network, destinations, *comm);
+
+	if( _proc == 0 ) {
+		cout << "Partition overlay: " << _overlay.getNVertices() << " boundary nodes, " << _overlay.getNEdges() << " edges" << endl;
+	}
+
+}
+
+
 void Model::compute_initial_paths() {
 
+	// Initial paths shared among every process, the ones of the distributed cache being applied from the batch
+	// delivered (a near cache smaller than the batch would evict them before they are read)
+
+	map<pair<int, int>, vector<int>> initial_paths;
+	if( _route_tasks_interval > 0 ) {
+
+		auto it_cur = (*agents).localBegin();
+		while ( it_cur != (*agents).localEnd() ) {
+			string id_origin = (*it_cur)->getTrips()[0].getIdOrigin();
+			string id_destin = (*it_cur)->getTrips()[0].getIdDestination();
+			if( _dest_trees.isHot(id_destin) == false && (*it_cur)->getTrips()[0].getPath().empty() == true ) {
+				publishRoute(id_origin, id_destin, _proc);
+			}
+			it_cur++;
+		}
+
+		unsigned int n_computed = 0;
+		if( _use_route_cache == true ) {
+			n_computed = _route_cache.exchange(_network, *RepastProcess::instance()->getCommunicator(), getRoutingCost().get(), &initial_paths);
+		}
+		else {
+			vector<pair<std::string, std::string>> delivered;
+			n_computed = _route_tasks.run(_network, *RepastProcess::instance()->getCommunicator(), _look_up_paths, &delivered, getRoutingCost().get());
+			for( const auto& od : delivered ) indexCachedPath(od.first, od.second);
+		}
+		cout << "INFO: Proc " << _proc << " computed " << n_computed << " initial paths" << endl;
+
+	}
+
 	// Loop over every local agent belonging to the SharedContext
 
 	auto it_cur = (*agents).localBegin();
 	while ( it_cur != (*agents).localEnd() ) {
 
-		// generation of the agent location in the continuous space
-		(*it_cur)->setX( _network.getNodes().at( (*it_cur)->getTrips()[0].getIdOrigin()).getX() );
-		(*it_cur)->setY( _network.getNodes().at( (*it_cur)->getTrips()[0].getIdOrigin()).getY() );
+		// generation of the agent location in the continuous space (start of its link if already on the road)
+		string id_location = (*it_cur)->getTrips()[0].getIdOrigin();
+		if( (*it_cur)->isEnRoute() == true ) id_location = _network.getLinks().at( (*it_cur)->getCurLink() ).getStartNodeId();
+		(*it_cur)->setX( _network.getNodes().at(id_location).getX() );
+		(*it_cur)->setY( _network.getNodes().at(id_location).getY() );
 		repast::Point<double> initialLocation( (*it_cur)->getX(), (*it_cur)->getY() );
 
 		// moving it to the location
@@ -413,15 +925,35 @@ void Model::compute_initial_paths() {
 
 		//cout << "compute initial path for individual " << (*it_cur)->getId().id() << endl;
 
-		vector<std::string> path;
-		if( _look_up_paths.count(id_origin) == 1 && _look_up_paths[id_origin].count(id_destin) == 1 ) {
-			path = _look_up_paths[id_origin][id_destin];
+		// agents heading to a hot destination follow its tree, no path is stored
+		if( _dest_trees.isHot(id_destin) == true ) {
+			(*it_cur)->setOnDestTree(true);
+		}
+		// ... with a sharded network, an agent leaving the partition gets its path from the next process
+		else if( _network.isInPartition(id_origin) == false ) {
+			(*it_cur)->setPath( vector<std::string>() );
+		}
+		// ... a path imported with the trips is used as is
+		else if( (*it_cur)->getTrips()[0].getPath().empty() == false ) {
+			(*it_cur)->setPath( (*it_cur)->getTrips()[0].getPath() );
+		}
+		else if( initial_paths.empty() == false && initial_paths.count(make_pair(_network.getNodeIndex(id_origin), _network.getNodeIndex(id_destin))) == 1 ) {
+			vector<std::string> path;
+			for( int l : initial_paths.at(make_pair(_network.getNodeIndex(id_origin), _network.getNodeIndex(id_destin))) ) path.push_back(_network.getLinkIdByIndex(l));
+			(*it_cur)->setPath( path );
+		}
+		else {
+			(*it_cur)->setPath( lookUpPath(id_origin, id_destin, RouteSite::INITIAL) );
+		}
+
+		// agents already on the road load their link, the others wait for their departure from the beginning of the time window
+		if( (*it_cur)->isEnRoute() == true ) {
+			updateLinkLoad( (*it_cur)->getCurLink(), 1 );
+			this->_total_moving_agents.incrementData();
 		}
 		else {
-			path = _network.computePathAStar( id_origin, id_destin );
-			_look_up_paths[id_origin][id_destin] = path;
+			(*it_cur)->setRemainingTime( max( (*it_cur)->getRemainingTime() - _start_time, 0.0f ) );
 		}
-		(*it_cur)->setPath( path );
 
 		// moving to next agent
 		it_cur++;
@@ -488,36 +1020,88 @@ void Model::initSchedule() {
 	runner.scheduleEvent(1,     1, Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::step)));
 	runner.scheduleEvent(1.1, 100, Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::checkStop)));
 
-	// Schedule the data recording and writing
+	// Stop at the end of the time window, one tick being one second
 
-	runner.scheduleEndEvent(Schedule::FunctorPtr(new MethodFunctor<DataSet>(_data_collection, &DataSet::write)));
-	runner.scheduleEndEvent(Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::writeLinksState)));
-	runner.scheduleEndEvent(Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::writeTripsStartingTimes)));
-	runner.scheduleEndEvent(Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::writeAgentFitness)));
+	if( hasTimeWindowEnd() == true ) {
+		runner.scheduleStop(_end_time - _start_time + 0.5);
+		runner.scheduleEndEvent(Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::writeWarmStart)));
+	}
 
-}
+	// Network events, applied just before the step reaching their time
 
+	for( const auto& events : _network_events ) {
+		runner.scheduleEvent(max(events.first - _start_time, 1.0f) - 0.5, Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::applyNetworkEvents)));
+	}
 
-void Model::providePackage(Individual * agent, std::vector<IndividualPackage>& out) {
+	// Rebuild the destination trees periodically
 
-	AgentId id = agent->getId();
-	IndividualPackage package = { id.id(), id.startingRank(), id.agentType(), id.currentRank(),
-			agent->getTrips(), agent->getX(), agent->getY(), agent->getRemainingTime(),
-			agent->getStrategy(), agent->getPath(), agent->isEnRoute(), agent->isAtNode(),
-			agent->getCurLink(), agent->getSize(), agent->getCurTripDurationTheo(),
-			agent->getNPathPerformed(), agent->getNLinkInPath()};
-	out.push_back(package);
+	if( _dest_trees.size() > 0 && _dest_trees_interval > 0 ) {
+		runner.scheduleEvent(_dest_trees_interval + 0.2, _dest_trees_interval, Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::updateDestinationTrees)));
+	}
 
-}
+	// Gather the congested links time at every routing epoch, before the trees and requests using them
 
+	if( _link_times.isBuilt() == true ) {
+		runner.scheduleEvent(_link_times_interval + 0.1, _link_times_interval, Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::updateLinkTimes)));
+	}
 
-Individual * Model::createAgent(IndividualPackage package) {
+	// Compute the published routing requests periodically
+
+	if( _route_tasks_interval > 0 ) {
+		runner.scheduleEvent(_route_tasks_interval + 0.3, _route_tasks_interval, Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::runRouteTasks)));
+	}
+
+	// Snapshot of the vehicles positions periodically
+
+	if( _positions_interval > 0 ) {
+		runner.scheduleEvent(_positions_interval + 0.4, _positions_interval, Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::writePositions)));
+		runner.scheduleEndEvent(Schedule::FunctorPtr(new MethodFunctor<PositionsWriter>(&_positions, &PositionsWriter::close)));
+	}
+
+	if( _route_log.isOpen() == true ) {
+		runner.scheduleEndEvent(Schedule::FunctorPtr(new MethodFunctor<RouteLog>(&_route_log, &RouteLog::close)));
+	}
+
+	// Schedule the data recording and writing
+
+	runner.scheduleEndEvent(Schedule::FunctorPtr(new MethodFunctor<DataSet>(_data_collection, &DataSet::write)));
+	runner.scheduleEndEvent(Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::writeLinksState)));
+	runner.scheduleEndEvent(Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::writeTripsStartingTimes)));
+	runner.scheduleEndEvent(Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::writeAgentFitness)));
+	if( _step_stats == true ) runner.scheduleEndEvent(Schedule::FunctorPtr(new MethodFunctor<Model>(this, &Model::writeStepStats)));
+
+}
+
+
+void Model::providePackage(Individual * agent, std::vector<IndividualPackage>& out) {
+
+	AgentId id = agent->getId();
+	IndividualPackage package = { id.id(), id.startingRank(), id.agentType(), id.currentRank(),
+			agent->getTrips(), agent->getX(), agent->getY(), agent->getRemainingTime(),
+			agent->getStrategy(), agent->getPath(), agent->isEnRoute(), agent->isAtNode(),
+			agent->getCurLink(), agent->getSize(), agent->getCurTripDurationTheo(),
+			agent->getNPathPerformed(), agent->getNLinkInPath(), agent->isOnDestTree(), agent->getFitness()};
+	out.push_back(package);
+
+}
+
+
+Individual * Model::createAgent(IndividualPackage package) {
 
 	repast::AgentId id(package.id, package.init_proc, MODEL_AGENT_IND_TYPE, package.cur_proc);
-	return new Individual(id, package.trips, package.x, package.y, package.remaining_time,
+	Individual * agent = new Individual(id, package.trips, package.x, package.y, package.remaining_time,
 			package.strategy, package.path, package.en_route, package.at_node,
 			package.cur_link, package.size, package.cur_trip_duration_theo,
-			package.n_path_performed, package.n_link_in_path);
+			package.n_path_performed, package.n_link_in_path, package.on_dest_tree, package.fitness);
+
+	if( _reorder_interval > 0 ) _agents_arrived.push_back(agent);
+
+	// ... its destinations being completed once every agent migrated (sharded network)
+	if( _network.getPartition() >= 0 ) {
+		for( const auto& t : package.trips ) _arrived_destinations.insert(t.getIdDestination());
+	}
+
+	return agent;
 
 }
 
@@ -551,6 +1135,8 @@ void Model::updateAgent(IndividualPackage package) {
 	agent->setCurTripDurationTheo(package.cur_trip_duration_theo);
 	agent->setNPathPerformed(package.n_path_performed);
 	agent->setNLinkInPath(package.n_link_in_path);
+	agent->setOnDestTree(package.on_dest_tree);
+	agent->setFitness(package.fitness);
 
 }
 
@@ -605,219 +1191,862 @@ void Model::step() {
 		cur_time_interval = cur_time_interval % n_int;
 	}
 
-	// Main loop: traffic dynamic
+	// Classification: agents due to an event during the step, by event
 
-	auto it_cur = (*agents).localBegin();
-	while( it_cur != (*agents).localEnd() ) {
+	_due_entries.clear();
+	_due_arrivals.clear();
+	_due_trip_ends.clear();
 
-		bool remove_agent = false;
+	// ... in the order of the context, or by link
+	if( _reorder_interval > 0 ) {
+		if( _agents_order.size() != (unsigned int)agents->size() || (long)( _time - _start_time ) % _reorder_interval == 0 ) reorderAgents();
+	}
+	else {
+		_agents_order.clear();
+		_agents_left.clear();
+		for( auto it = (*agents).localBegin(); it != (*agents).localEnd(); it++ ) _agents_order.push_back((*it).get());
+	}
+
+	if( _step_stats == true ) _step_misses.start();
 
-		//	(*it_cur)->print();
+	for( auto agent : _agents_order ) {
 
 		// Decreasing agent remaining time till next event
+		agent->decreaseRemainingTime( global_remaining_time );
+		if( agent->getRemainingTime() > this->_time_tolerance ) continue;
+
+		// ... at a node: entering its next link, on a link: reaching its end node or the end of its trip
+		if( agent->isAtNode() == true )         _due_entries.push_back(agent);
+		else if( hasLinksLeft(agent) == true ) _due_arrivals.push_back(agent);
+		else                                   _due_trip_ends.push_back(agent);
+
+	}
+
+	// Processing of every event, the agents leaving their link before the ones entering one
 
-		(*it_cur)->decreaseRemainingTime( global_remaining_time );
+	arriveAtNodes(_due_arrivals);
+	endTrips(_due_trip_ends);
+	enterLinks(_due_entries, cur_time_interval);
 
-		// Moving active agent to its next event
+	if( _step_stats == true ) {
+		_step_misses.stop();
+		_n_agents_stepped += _agents_order.size();
+		for( unsigned int i = 1; i < _agents_order.size(); i++ ) {
+			Individual* prev = _agents_order[i - 1];
+			Individual* cur  = _agents_order[i];
+			if( _agents_left.count(prev) == 0 && _agents_left.count(cur) == 0 && prev->getCurLink() != cur->getCurLink() ) _n_link_switches++;
+		}
+	}
 
-		if( (*it_cur)->getRemainingTime() <= this->_time_tolerance ) {
+	// Snapshot of the links state
 
-			// Agent is at a node -> preparing to move to the next one
-			if( (*it_cur)->isAtNode() == true) {
+	if( (int)floorf(_time) % (_time_interval_records_snapshots * 60 ) == 0.0 ) {
 
-				// agent is starting a new trip
-				if( (*it_cur)->isEnRoute() == false ) {
-					(*it_cur)->setEnRoute(true);
-					this->_total_moving_agents.incrementData();
-					this->_trips_starting_time.push_back(this->_time);
+		unsigned int interval = (int)floorf(_time) / (_time_interval_records_snapshots * 60 );
 
+		if( _time > 86400.0f) {
+			const static unsigned int n_int_snapshot = 1440 / _time_interval_records_snapshots;
+			interval = interval % n_int_snapshot;
+		}
+
+		auto it = (*agents).localBegin();
+		while( it != (*agents).localEnd() ) {
+			if( (*it)->isEnRoute() == true ) {
+				// ... agents on a super link are located on one of its original links
+				std::string id_link = (*it)->getCurLink();
+				if( _network.isChain(id_link) == true ) {
+					float progress = 1.0f;
+					if( (*it)->isAtNode() == false ) progress = 1.0f - (*it)->getRemainingTime() / _network.getLinks().at(id_link).timeOnLink();
+					id_link = _network.getOriginalLinkAt(id_link, max(0.0f, progress));
 				}
+				_links_state_snapshot[id_link][interval]++;
+			}
+			it++;
+		}
 
-				// Setting the agent to move, determining its next planned link and moving to it
-				(*it_cur)->setAtNode(false);
-				std::string id_next_link = (*it_cur)->getNextLinkAndRemove();
-				(*it_cur)->setCurLink(id_next_link);
+	}
 
-				//cout << "DEBUG: Agent at node " <<  _network.getLinks().at( (*it_cur)->getCurLink() ).getStartNodeId() << endl;
-				//cout << "DEBUG:    next link " << id_next_link << endl;
+	// Recording aggregate data
 
-				// Determining and applying strategy: agent stays on the link or decide to take an other one
-				if  ( (*it_cur)->getStrategy().isOptimized()    == true &&
-					  (*it_cur)->isRerouting( _network, _time ) == true ) {
+	this->_total_agents.setData(this->agents->size());
+	this->_data_collection->record();
 
-					// Incrementing the number of rerouting
-					this->_total_rerouting.incrementData();
+	// Synchronizing the links load (agents decomposition) or the agents states (eventually moving them to a new process)
 
-					// Determining new path by avoiding the next link initially planned
-					std::string cur_node_id  = _network.getLinks().at( (*it_cur)->getCurLink() ).getStartNodeId();
-					if( _network.getNodes().at(cur_node_id).getLinksOutId().size() > 1 ) {
+	if( _decomposition == Decomposition::AGENTS ) exchangeLinkLoads();
+	if( _reorder_interval > 0 ) {
+		for( const auto& m : _map_agents_to_move_process ) _agents_left.insert(agents->getAgent(m.first));
+	}
+	this->synch_agents();
+	if( _reorder_interval > 0 ) repairAgentsOrder();
 
-						std::string dest_node_id = (*it_cur)->getTrips().front().getIdDestination();
-						vector<std::string> new_path = _network.computePath(cur_node_id, dest_node_id, id_next_link);
-						(*it_cur)->setPath( new_path );
-						id_next_link = (*it_cur)->getNextLinkAndRemove();
-						(*it_cur)->setCurLink(id_next_link);
-						//cout << "DEBUG:    NEW next link " << id_next_link << endl;
-					}
+	// Destinations of the migrated agents completed by the processes owning them
+	if( _network.getPartition() >= 0 ) {
+		_overlay.completeDestinations(_network, _arrived_destinations, *RepastProcess::instance()->getCommunicator());
+		_arrived_destinations.clear();
+	}
+
+}
 
+
+void Model::reorderAgents() {
+
+	// (link index, remaining time) of every agent, the agents not on a link first
+	vector<pair<pair<int, float>, Individual*>> keys;
+	keys.reserve(agents->size());
+	for( auto it = (*agents).localBegin(); it != (*agents).localEnd(); it++ ) {
+		Individual* agent = (*it).get();
+		int link = -1;
+		if( agent->isEnRoute() == true && agent->isAtNode() == false ) link = _network.getLinkIndex(agent->getCurLink());
+		keys.push_back(make_pair(make_pair(link, agent->getRemainingTime()), agent));
+	}
+	sort(keys.begin(), keys.end());
+
+	_agents_order.clear();
+	for( const auto& k : keys ) _agents_order.push_back(k.second);
+	_agents_left.clear();
+	_agents_arrived.clear();
+
+}
+
+
+void Model::repairAgentsOrder() {
+
+	// ... the removed agents first, their memory being possibly reused by the arrived ones
+	if( _agents_left.empty() == false ) {
+		_agents_order.erase(remove_if(_agents_order.begin(), _agents_order.end(),
+				                      [this](Individual* a) { return _agents_left.count(a) == 1; }), _agents_order.end());
+	}
+	_agents_order.insert(_agents_order.end(), _agents_arrived.begin(), _agents_arrived.end());
+
+	_agents_left.clear();
+	_agents_arrived.clear();
+
+}
+
+
+void Model::enterLinks(const std::vector<Individual*>& due, int cur_time_interval) {
+
+	// Next link of every agent, eventually rerouted by its strategy, the agents without a path being dropped
+	vector<Individual*> entering;
+	vector<std::string> next_links;
+	vector<Individual*> dropped;
+	entering.reserve(due.size());
+	next_links.reserve(due.size());
+	for( unsigned int i = 0; i < due.size(); i++ ) {
+
+		Individual* agent = due[i];
+
+		// agent is starting a new trip
+		if( agent->isEnRoute() == false ) {
+			agent->setEnRoute(true);
+			this->_total_moving_agents.incrementData();
+			this->_trips_starting_time.push_back(this->_time);
+		}
+
+		// Setting the agent to move, determining its next planned link and moving to it
+		agent->setAtNode(false);
+		std::string id_next_link = moveToNextLink(agent);
+		if( id_next_link.empty() == true ) {
+			dropped.push_back(agent);
+			continue;
+		}
+		agent->setCurLink(id_next_link);
+
+		// Determining and applying strategy: agent stays on the link or decide to take an other one
+		if  ( agent->getStrategy().isOptimized()    == true &&
+			  agent->isRerouting( _network, _time ) == true ) {
+
+			// Incrementing the number of rerouting
+			this->_total_rerouting.incrementData();
+
+			// Determining new path by avoiding the next link initially planned
+			std::string cur_node_id  = _network.getLinks().at( agent->getCurLink() ).getStartNodeId();
+			if( _network.getNodes().at(cur_node_id).getLinksOutId().size() > 1 ) {
+
+				std::string dest_node_id = agent->getTrips().front().getIdDestination();
+				vector<std::string> new_path = computePath(cur_node_id, dest_node_id, RouteSite::REROUTE, id_next_link);
+				// ... keeping the planned link if no other path is found
+				if( new_path.empty() == false ) {
+					agent->setOnDestTree(false);
+					agent->setPath( new_path );
+					id_next_link = agent->getNextLinkAndRemove();
+					agent->setCurLink(id_next_link);
 				}
+			}
+
+		}
+
+		entering.push_back(agent);
+		next_links.push_back(id_next_link);
+
+	}
+
+	// Removing the agents whose destination cannot be reached from their node (sharded network, the
+	// reachability of the trips being unknown at load)
+	for( auto agent : dropped ) {
+		cerr << "WARNING: Proc " << _proc << " dropped agent " << agent->getId().id() << " at node " << getCurNodeId(agent)
+			 << ": no path to its destination " << agent->getTrips().front().getIdDestination() << endl;
+		this->_total_moving_agents.decrementData();
+		if( _reorder_interval > 0 || _step_stats == true ) _agents_left.insert(agent);
+		AgentId agt_id = agent->getId();
+		this->continuous_space->removeAgent( agent );
+		this->agents->removeAgent( agt_id );
+	}
+
+	// Occupancy of the links, in the order of the agents: every agent travels its link at the time given by the agents before it
+	for( unsigned int i = 0; i < entering.size(); i++ ) {
 
-				// Updating agent theoretical travel time
-				(*it_cur)->increaseTripDurationTheo( _network.getLinks().at(id_next_link).getFreeFlowTime() );
+		Individual*  agent = entering[i];
+		const Link&  lnk   = _network.getLinks().at(next_links[i]);
 
-				// Adding the agent to the next link it takes and computing the time required to travel
-				(*it_cur)->setRemainingTime( this->_network.getLinks().at(id_next_link).timeOnLink() );
-				_network.incrementAgentOnLink(id_next_link);
+		// Updating agent theoretical travel time
+		agent->increaseTripDurationTheo( lnk.getFreeFlowTime() );
 
-				// Link densities recording
-				this->_links_load_over_time[id_next_link][cur_time_interval]++;
+		// Adding the agent to the next link it takes and computing the time required to travel
+		agent->setRemainingTime( lnk.timeOnLink() );
+		updateLinkLoad(next_links[i], 1);
 
-				// Recording the data for Moves:
-				// agent_id | link id | time entering the link | time on link | path id | link on path
-				this->writeOutputsMoves((*it_cur)->getId().id(), id_next_link, this->_time,
-						                (*it_cur)->getRemainingTime(), (*it_cur)->getNPathPerformed(), (*it_cur)->getNLinkInPath());
+		// Link densities recording
+		this->_links_load_over_time[next_links[i]][cur_time_interval]++;
 
+	}
+
+	// Recording the data for Moves:
+	// agent_id | link id | time entering the link | time on link | path id | link on path
+	for( unsigned int i = 0; i < entering.size(); i++ ) {
+		this->writeOutputsMoves(entering[i]->getId().id(), next_links[i], this->_time,
+				                entering[i]->getRemainingTime(), entering[i]->getNPathPerformed(), entering[i]->getNLinkInPath());
+	}
+
+}
+
+
+void Model::arriveAtNodes(const std::vector<Individual*>& due) {
 
+	for( auto agent : due ) {
+
+		// Decrement number of agent on previous link
+		std::string id_prev_link = agent->getCurLink();
+		updateLinkLoad(id_prev_link, -1);
+
+		// Moving to new node, i.e. destination of previous link
+		const Node& newNode = _network.getNodes().at( _network.getLinks().at(id_prev_link).getEndNodeId() );
+		agent->setX(newNode.getX());
+		agent->setY(newNode.getY());
+
+		// Stopping at the new node
+		agent->setAtNode(true);
+
+		// Moving agent in the continuous space
+		repast::Point<double> loc( agent->getX(), agent->getY() );
+		this->continuous_space->moveTo( agent->getId(), loc );
+
+	}
+
+	// Agents reaching a node of another process
+	if( _decomposition == Decomposition::SPATIAL ) {
+		for( auto agent : due ) {
+			if( isInLocalBounds(agent->getX(), agent->getY()) == false ) {
+				_map_agents_to_move_process[agent->getId()] = getNodeProcess( _network.getLinks().at(agent->getCurLink()).getEndNodeId() );
 			}
-			// Agent reaches the next node on its way
-			else {
+		}
+	}
 
-				// Moving to next node if not the final one of current trip
-				if( (*it_cur)->getPath().size() > 0 ) {
+}
 
-					// Decrement number of agent on previous link
-					std::string id_prev_link = (*it_cur)->getCurLink();
-					_network.decrementAgentOnLink(id_prev_link);
 
-					// Moving to new node, i.e. destination of previous link
-					std::string id_new_node = _network.getLinks().at(id_prev_link).getEndNodeId();
-					Node     newNode     = _network.getNodes().at(id_new_node);
-					(*it_cur)->setX(newNode.getX());
-					(*it_cur)->setY(newNode.getY());
+void Model::endTrips(const std::vector<Individual*>& due) {
 
-					// Stopping at the new node
-					(*it_cur)->setAtNode(true);
+	vector<Individual*> finished;
 
-					// Moving agent in the continuous space
-					repast::Point<double> loc( (*it_cur)->getX(), (*it_cur)->getY() );
-					this->continuous_space->moveTo( (*it_cur)->getId(), loc );
+	for( auto agent : due ) {
 
-					if( isInLocalBounds((*it_cur)->getX(), (*it_cur)->getY()) == false ) {
-						_map_agents_to_move_process[(*it_cur)->getId()] = _map_node_process[id_new_node];
-					}
+		// Computing its fitness
+		float start_time_trip   = agent->getTrips().front().getStartingTime();
+		float trip_duration_teo = agent->getCurTripDurationTheo();
+		float trip_duration_sim = this->_time - start_time_trip;
 
+		// update fitness (kept by the agent)
+		agent->addTripFitness( trip_duration_teo / trip_duration_sim );
 
-					
+		// Incrementing the number of trips performed
+		this->_total_trips_performed.incrementData();
 
-				}
+		// Decrementing the number of moving agent
+		this->_total_moving_agents.decrementData();
 
-				// Agent reached end of current trip
-				else {
+		// Decrementing the number of agent on previous link
+		updateLinkLoad( agent->getCurLink(), -1 );
+
+		//Agent arrived at final destination -> mark it for removing it from the simulation
+		if( agent->getTrips().size() <= 1 ) {
+			finished.push_back(agent);
+			continue;
+		}
+
+		//Agent arrived at destination -> preparing next trip
+		bool use_dest_tree = _dest_trees.isHot( agent->getTrips()[1].getIdDestination() );
+		agent->setNextTrip(_network, this->_time, use_dest_tree);
+
+		// ... its path computed on the routing costs of the model, unless computed at departure or published for any process to compute it
+		Trip next_trip  = agent->getTrips().front();
+		bool defer_path = _network.getPartition() >= 0 || _route_tasks_interval > 0;
+		if( use_dest_tree == false && defer_path == false && next_trip.getPath().empty() == true ) {
+			agent->setPath( computePath(next_trip.getIdOrigin(), next_trip.getIdDestination(), RouteSite::NEXT_TRIP) );
+		}
+		if( use_dest_tree == false && _route_tasks_interval > 0 && next_trip.getPath().empty() == true ) {
+			if( hasPath(next_trip.getIdOrigin(), next_trip.getIdDestination()) == false ) {
+				int deliver_to = _decomposition == Decomposition::SPATIAL ? getNodeProcess(next_trip.getIdOrigin()) : _proc;
+				publishRoute(next_trip.getIdOrigin(), next_trip.getIdDestination(), deliver_to);
+			}
+		}
 
-					// Computing its fitness
-					float start_time_trip   = (*it_cur)->getTrips().front().getStartingTime();
-					float trip_duration_teo = (*it_cur)->getCurTripDurationTheo();
-					float trip_duration_sim = this->_time - start_time_trip;
+		// Moving agent in the continuous space
+		repast::Point<double> loc( agent->getX(), agent->getY() );
+		this->continuous_space->moveTo( agent->getId(), loc );
 
-					// update fitness
+		if( _decomposition == Decomposition::SPATIAL && isInLocalBounds( agent->getX(), agent->getY()) == false ) {
+			_map_agents_to_move_process[agent->getId()] = getNodeProcess( agent->getTrips().front().getIdOrigin() );
+		}
 
-					float fitness  = trip_duration_teo / trip_duration_sim;
-					if ( this->_map_agent_fitness.find( (*it_cur)->getId().id() ) == this->_map_agent_fitness.end() ) {
-						_map_agent_fitness[(*it_cur)->getId().id()] = fitness;
+	}
 
-					} else {
-						_map_agent_fitness[(*it_cur)->getId().id()] = (_map_agent_fitness[(*it_cur)->getId().id()] + fitness) * 0.5;
-					}
+	// Removing the agents arrived at their final destination, keeping their results
+	for( auto agent : finished ) {
+		_finished_agents.push_back( agent->getId().id() );
+		_finished_fitness.push_back( agent->getFitness() );
+		if( _reorder_interval > 0 || _step_stats == true ) _agents_left.insert(agent);
+		AgentId agt_id = agent->getId();
+		this->continuous_space->removeAgent( agent );
+		this->agents->removeAgent( agt_id );
+	}
 
-					// Incrementing the number of trips performed
-					this->_total_trips_performed.incrementData();
+}
 
-					// Decrementing the number of moving agent
-					this->_total_moving_agents.decrementData();
 
-					// Decrementing the number of agent on previous link
-					_network.decrementAgentOnLink( (*it_cur)->getCurLink() );
+std::vector<std::string> Model::computePath(const std::string& source_id, const std::string& dest_id, RouteSite site,
+		                                    const std::string& link_id_to_avoid) {
 
-					//Agent arrived at destination -> preparing next trip if any
-					if( (*it_cur)->getTrips().size() > 1 ) {
+	auto start = chrono::steady_clock::now();
 
-						// Setting next trip
-						(*it_cur)->setNextTrip(_network, this->_time);
+	RouteMetric         metric;
+	vector<std::string> path;
+	if( _network.getPartition() >= 0 ) {
+		metric = RouteMetric::OVERLAY;
+		path   = _overlay.computePath(_network, source_id, dest_id, link_id_to_avoid);
+	}
+	else if( link_id_to_avoid.empty() == true && _link_times.isBuilt() == true ) {
+		metric = RouteMetric::TABLE;
+		path   = _network.computePath(source_id, dest_id, *_link_costs.read());
+	}
+	else if( link_id_to_avoid.empty() == true ) {
+		metric = RouteMetric::ASTAR;
+		path   = _network.computePathAStar(source_id, dest_id);
+	}
+	else {
+		metric = RouteMetric::AVOID;
+		path   = _network.computePath(source_id, dest_id, link_id_to_avoid);
+	}
 
-						// Moving agent in the continuous space
-						repast::Point<double> loc( (*it_cur)->getX(), (*it_cur)->getY() );
-						this->continuous_space->moveTo( (*it_cur)->getId(), loc );
+	if( _route_log.isOpen() == true ) {
+		double latency = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		_route_log.add(_network, site, metric, source_id, dest_id, link_id_to_avoid, _time, latency, path.size());
+	}
 
+	return path;
 
-						if( isInLocalBounds( (*it_cur)->getX(), (*it_cur)->getY()) == false ) {
-						//if(continuous_space->bounds().contains(loc) == false ) {
-							_map_agents_to_move_process[(*it_cur)->getId()] = _map_node_process[ (*it_cur)->getTrips().front().getIdOrigin() ];
-						}
+}
 
-					}
 
-					//Agent arrived at final destination -> mark it for removing it from the simulation
-					else {
-					  //cout << "REMOVING AGENT!" << endl;
-						remove_agent = true;
+bool Model::isRoutable(const std::string& origin_id, const std::string& dest_id) const {
 
+	if( _network.hasNode(origin_id) == false || _network.hasNode(dest_id) == false ) return false;
 
-					}
+	return _network.isReachable(origin_id, dest_id);
 
-				}
+}
 
+
+int Model::getNodeProcess(const std::string& node_id) {
+
+	if( _network.getPartition() < 0 ) return _map_node_process[node_id];
+
+	int owner = _network.getNodeOwner(node_id);
+	if( owner < 0 ) owner = _overlay.getDestinationOwner(node_id);
+
+	return owner < 0 ? _proc : owner;
+
+}
+
+
+bool Model::isLocalAgent(const std::string& origin_id, unsigned int n_trips) {
+
+	if( _decomposition == Decomposition::SPATIAL ) return _network.getNodeOwner(origin_id) == _proc;
+
+	int proc = (int)( min_element(_n_trips_proc.begin(), _n_trips_proc.end()) - _n_trips_proc.begin() );
+	_n_trips_proc[proc] += n_trips;
+
+	return proc == _proc;
+
+}
+
+
+void Model::updateLinkLoad(const std::string& linkId, int delta) {
+
+	if( delta > 0 ) _network.incrementAgentOnLink(linkId);
+	else            _network.decrementAgentOnLink(linkId);
+
+	if( _decomposition == Decomposition::AGENTS ) _link_deltas[_network.getLinkIndex(linkId)] += delta;
+
+}
+
+
+void Model::exchangeLinkLoads() {
+
+	boost::mpi::communicator* comm = RepastProcess::instance()->getCommunicator();
+
+	// Only the links whose load changed are sent: (link index, change) pairs
+	vector<int> changes;
+	for( const auto& d : _link_deltas ) {
+		if( d.second != 0 ) {
+			changes.push_back(d.first);
+			changes.push_back(d.second);
+		}
+	}
+	_link_deltas.clear();
+
+	vector<vector<int>> changes_gather;
+	boost::mpi::all_gather(*comm, changes, changes_gather);
+
+	// ... the local changes being already applied
+	for( int p = 0; p < (int)changes_gather.size(); p++ ) {
+		if( p == _proc ) continue;
+		for( unsigned int i = 0; i < changes_gather[p].size(); i += 2 ) {
+			_network.addAgentsOnLink(_network.getLinkIdByIndex(changes_gather[p][i]), changes_gather[p][i + 1]);
+		}
+	}
+
+}
+
+
+void Model::reduceLinksRecords() {
+
+	boost::mpi::communicator* comm = RepastProcess::instance()->getCommunicator();
+
+	// Every process holds the same links, in the same order
+	for( auto records : { &_links_load_over_time, &_links_state_snapshot } ) {
+
+		vector<int> local_records;
+		for( const auto& lnk : *records ) local_records.insert(local_records.end(), lnk.second.begin(), lnk.second.end());
+
+		vector<int> total_records(local_records.size(), 0);
+		boost::mpi::reduce(*comm, local_records.data(), (int)local_records.size(), total_records.data(), std::plus<int>(), 0);
+
+		if( _proc == 0 ) {
+			unsigned int i = 0;
+			for( auto& lnk : *records ) {
+				for( auto& r : lnk.second ) r = total_records[i++];
 			}
+		}
+		else {
+			records->clear();
+		}
+
+	}
+
+}
+
+
+void Model::publishRoute(const std::string& source_id, const std::string& dest_id, int deliver_to) {
+
+	// computed later in a batch, at free flow or on the costs of the link times table
+	if( _route_log.isOpen() == true ) {
+		RouteMetric metric = _link_times.isBuilt() == true ? RouteMetric::TABLE : RouteMetric::ASTAR;
+		_route_log.add(_network, RouteSite::PUBLISHED, metric, source_id, dest_id, "", _time, 0.0, 0);
+	}
+
+	if( _use_route_cache == true ) _route_cache.request(_network, source_id, dest_id, deliver_to, RepastProcess::instance()->worldSize());
+	else                           _route_tasks.publish(source_id, dest_id, deliver_to);
+
+}
+
 
+bool Model::hasPath(const std::string& source_id, const std::string& dest_id) {
+
+	if( _use_route_cache == true ) return _route_cache.contains(_network, source_id, dest_id);
+
+	return _look_up_paths.count(source_id) == 1 && _look_up_paths[source_id].count(dest_id) == 1;
+
+}
+
+
+std::vector<std::string> Model::lookUpPath(const std::string& source_id, const std::string& dest_id, RouteSite site) {
+
+	// Paths found being logged as requests answered by the cache, with the latency of the look up
+	auto start  = chrono::steady_clock::now();
+	auto log_hit = [this, &start, &source_id, &dest_id, site](const vector<std::string>& path) {
+		if( _route_log.isOpen() == false ) return;
+		double latency = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		_route_log.add(_network, site, RouteMetric::CACHED, source_id, dest_id, "", _time, latency, path.size());
+	};
+
+	// Near cache in front of the distributed cache, the paths missing being computed and kept locally
+	if( _use_route_cache == true ) {
+		vector<std::string> path;
+		if( _route_cache.find(_network, source_id, dest_id, path) == true ) {
+			log_hit(path);
+			return path;
 		}
+		path = computePath(source_id, dest_id, site);
+		_route_cache.insert(_network, source_id, dest_id, path);
+		return path;
+	}
 
-		// Moving to next agent
+	auto it_source = _look_up_paths.find(source_id);
+	if( it_source != _look_up_paths.end() ) {
+		auto it_dest = it_source->second.find(dest_id);
+		if( it_dest != it_source->second.end() ) {
+			log_hit(it_dest->second);
+			return it_dest->second;
+		}
+	}
 
-		Individual* agt = (*it_cur).get();
-		AgentId agt_id = (*it_cur)->getId();
+	vector<std::string> path = computePath(source_id, dest_id, site);
+	_look_up_paths[source_id][dest_id] = path;
+	indexCachedPath(source_id, dest_id);
 
-		//if (remove_agent == true) {
-		//	cout << "ID TO REMOVE: " << agt_id.id() << endl;
-		//}
+	return path;
 
-		it_cur++;
+}
+
+
+void Model::indexCachedPath(const std::string& source_id, const std::string& dest_id) {
+
+	if( _network_events.empty() == true && _link_times.isBuilt() == false ) return;
+
+	for( const auto& l : _look_up_paths[source_id][dest_id] ) _cached_paths_by_link[l].insert(make_pair(source_id, dest_id));
+
+}
+
+
+std::string Model::getCurNodeId(Individual * agent) {
+
+	// Origin of the trip if it just started, end of the current link otherwise
+	if( agent->getNLinkInPath() == 0 ) return agent->getTrips().front().getIdOrigin();
+
+	return _network.getLinks().at(agent->getCurLink()).getEndNodeId();
+
+}
+
+
+std::string Model::moveToNextLink(Individual * agent) {
+
+	if( agent->isOnDestTree() == false ) {
 
-		if (remove_agent == true) {
-		//		cout << "ID BEING REMOVED: " << agt_id.id() << endl;
-			this->continuous_space->removeAgent( agt );
-			this->agents->removeAgent( agt_id );
+		// path not computed yet (deferred at the end of the previous trip), or, with a sharded network,
+		// stopping at the end of the previous partition
+		if( agent->getPath().empty() == true ) {
+			agent->setPath( lookUpPath(getCurNodeId(agent), agent->getTrips().front().getIdDestination(), RouteSite::DEPARTURE) );
+			if( agent->getPath().empty() == true ) return "";
 		}
 
+		return agent->getNextLinkAndRemove();
 
+	}
+
+	std::string cur_node_id  = getCurNodeId(agent);
+	std::string dest_node_id = agent->getTrips().front().getIdDestination();
 
+	// Looking up the next link in the destination tree
+	int next_link = _dest_trees.nextLink(dest_node_id, _network.getNodeIndex(cur_node_id));
+	if( next_link >= 0 ) {
+		std::string id_next_link = _network.getLinkIdByIndex(next_link);
+		agent->takeLink(id_next_link);
+		return id_next_link;
 	}
 
-	// Snapshot of the links state
+	// ... destination not reachable through the tree, falling back to a path
+	agent->setOnDestTree(false);
+	auto start = chrono::steady_clock::now();
+	agent->setPath( _network.computePathAStar(cur_node_id, dest_node_id) );
+	if( _route_log.isOpen() == true ) {
+		double latency = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		_route_log.add(_network, RouteSite::TREE_EXIT, RouteMetric::ASTAR, cur_node_id, dest_node_id, "", _time, latency, agent->getPath().size());
+	}
+	if( agent->getPath().empty() == true ) return "";
+	return agent->getNextLinkAndRemove();
 
-	if( (int)floorf(_time) % (_time_interval_records_snapshots * 60 ) == 0.0 ) {
+}
 
-		unsigned int interval = (int)floorf(_time) / (_time_interval_records_snapshots * 60 );
 
-		if( _time > 86400.0f) {
-			const static unsigned int n_int_snapshot = 1440 / _time_interval_records_snapshots;
-			interval = interval % n_int_snapshot;
+bool Model::hasLinksLeft(Individual * agent) {
+
+	if( agent->isOnDestTree() == false && _network.getPartition() < 0 ) return agent->getPath().size() > 0;
+
+	return _network.getLinks().at(agent->getCurLink()).getEndNodeId() != agent->getTrips().front().getIdDestination();
+
+}
+
+
+void Model::runRouteTasks() {
+
+#ifdef DEBUGSIM
+	cout << "Proc " << _proc << ": " << _route_tasks.size() + _route_cache.size() << " routing requests published" << endl;
+#endif
+
+	LinkCostSnapshot::Snapshot cost = getRoutingCost();
+
+	if( _use_route_cache == true ) {
+		_route_cache.exchange(_network, *RepastProcess::instance()->getCommunicator(), cost.get());
+		return;
+	}
+
+	vector<pair<std::string, std::string>> delivered;
+	_route_tasks.run(_network, *RepastProcess::instance()->getCommunicator(), _look_up_paths, &delivered, cost.get());
+	for( const auto& od : delivered ) indexCachedPath(od.first, od.second);
+
+}
+
+
+void Model::updateDestinationTrees() {
+
+	_dest_trees.rebuild(_network, getCurrentLinksTime(), *RepastProcess::instance()->getCommunicator());
+
+}
+
+
+void Model::updateLinkTimes() {
+
+	// Every process holds the global load with the agents decomposition, only the load of its links otherwise
+	_link_times.update(_network.getLinksTime(), _network.getLinksTime(_network.getLinksNAgents()), *RepastProcess::instance()->getCommunicator());
+
+	// ... the costs and the cached paths using the links changed, identical on every process, refreshed
+	set<std::string> changed;
+	for( int l : _link_times.getChanged() ) changed.insert(_network.getLinkIdByIndex(l));
+	if( changed.empty() == false ) invalidateRouting(changed);
+
+#ifdef DEBUGSIM
+	if( _proc == 0 ) cout << "Routing epoch " << _link_times.getNEpochs() << ": " << _link_times.getNChanged() << " links time changed" << endl;
+#endif
+
+}
+
+
+std::vector<float> Model::getCurrentLinksTime() {
+
+	if( _link_times.isBuilt() == true ) return *_link_costs.read();
+
+	boost::mpi::communicator* comm = RepastProcess::instance()->getCommunicator();
+
+	// A link is only loaded on the process owning its source node, summing gives the global state
+	// (with the agents decomposition every process already knows the global state)
+	vector<unsigned int> n_agents_local = _network.getLinksNAgents();
+	vector<unsigned int> n_agents_total = n_agents_local;
+	if( _decomposition == Decomposition::SPATIAL ) {
+		boost::mpi::all_reduce(*comm, n_agents_local.data(), (int)n_agents_local.size(), n_agents_total.data(), std::plus<unsigned int>());
+	}
+
+	return _network.getLinksTime(n_agents_total);
+
+}
+
+
+void Model::init_link_times() {
+
+	if( _props.contains("par.link_times_interval") ) _link_times_interval = boost::lexical_cast<unsigned int>(_props.getProperty("par.link_times_interval"));
+	if( _link_times_interval == 0 ) return;
+
+	if( _network.getPartition() >= 0 ) {
+		if( _proc == 0 ) cout << "WARNING: the global link times table is disabled with a sharded network" << endl;
+		_link_times_interval = 0;
+		return;
+	}
+
+	float step = 0.01f;
+	if( _props.contains("par.link_times_step") ) step = boost::lexical_cast<float>(_props.getProperty("par.link_times_step"));
+	if( step <= 0.0f ) {
+		cerr << "Invalid link times step: " << step << endl;
+		throw "Error in properties";
+	}
+
+	// Links published by the process, each link by exactly one process
+	int n_proc  = RepastProcess::instance()->worldSize();
+	int n_links = _network.getNLinksIndexed();
+	vector<int> owned;
+	for( int l = 0; l < n_links; l++ ) {
+		int owner = l % n_proc;
+		if( _decomposition == Decomposition::SPATIAL ) owner = _network.getNodeOwner(_network.getNodeIdByIndex(_network.getLinkStartIndex(l)));
+		if( owner == _proc ) owned.push_back(l);
+	}
+
+	_link_times.build(n_links, owned, step);
+	_link_costs.write() = _network.getLinksTime();
+	_link_costs.publish();
+
+	if( _proc == 0 ) cout << "INFO: routing epochs of " << _link_times_interval << " s on the global link times table" << endl;
+
+}
+
+
+void Model::init_network_events() {
+
+	if( _props.contains("file.network_events") == false || _props.getProperty("file.network_events").empty() == true ) return;
+
+	string filename = this->_props.getProperty("file.network_events");
+	ifstream file(filename.c_str(), ios::in);
+	string a_line;
+	unsigned int n_events  = 0;
+	unsigned int n_ignored = 0;
+
+	if (file) {
+
+		getline(file, a_line);                                              // skipping header line
+		while (getline(file, a_line)) {
+
+			// extracting data: time, link, attribute and value
+			auto data = split<string>(a_line, ";");
+			if( data.size() < 4 ) continue;
+
+			NetworkEvent event = { data[1], data[2], boost::lexical_cast<float>(data[3]) };
+			if( ( event.attribute != "capacity" && event.attribute != "freespeed" ) || event.value <= 0.0f ) {
+				cerr << "Invalid network event: " << a_line << endl;
+				throw "Error in network events file";
+			}
+
+			// ... events after the time window or, with the whole network, on unknown links are ignored
+			float time = boost::lexical_cast<float>(data[0]);
+			if( time >= _end_time || ( _network.getPartition() < 0 && _network.hasOriginalLink(event.link) == false ) ) {
+				++n_ignored;
+				continue;
+			}
+
+			_network_events[time].push_back(event);
+			++n_events;
+
 		}
 
-		auto it = (*agents).localBegin();
-		while( it != (*agents).localEnd() ) {
-			if( (*it)->isEnRoute() == true ) _links_state_snapshot[(*it)->getCurLink()][interval]++;
-			it++;
+		file.close();
+
+	} else {
+		cerr << "Could not open " << filename << endl;
+		throw "Error opening network events file";
+	}
+
+	if( _proc == 0 ) {
+		cout << "INFO: " << n_events << " network events at " << _network_events.size() << " times";
+		if( n_ignored > 0 ) cout << " (" << n_ignored << " ignored)";
+		cout << endl;
+	}
+
+}
+
+
+void Model::applyNetworkEvents() {
+
+	if( _network_events.empty() == true ) return;
+
+	// Events of the next time, with the sharded network only on the links of the partition
+	auto it = _network_events.begin();
+	set<std::string> changed;
+	for( const auto& event : it->second ) {
+
+		if( _network.hasOriginalLink(event.link) == false ) continue;
+
+		const Link& lnk = _network.getOriginalLink(event.link);
+		float capacity  = lnk.getCapacity();
+		float ff_time   = lnk.getFreeFlowTime();
+		if( event.attribute == "capacity" ) capacity = event.value;
+		else                                ff_time  = lnk.getLength() / event.value;
+
+		changed.insert(_network.changeLink(event.link, capacity, ff_time));
+
+	}
+
+	if( _proc == 0 ) cout << "INFO: " << it->second.size() << " network events applied (time " << it->first << ")" << endl;
+	_network_events.erase(it);
+
+	invalidateRouting(changed);
+
+	if( _network_events.empty() == true && _link_times.isBuilt() == false ) _cached_paths_by_link.clear();
+
+}
+
+
+void Model::invalidateRouting(const std::set<std::string>& links) {
+
+	// Paths of the look up table using the links, removed from the index of every link they use
+	unsigned int n_paths = 0;
+	for( const auto& l : links ) {
+		auto it = _cached_paths_by_link.find(l);
+		if( it == _cached_paths_by_link.end() ) continue;
+		set<pair<std::string, std::string>> ods;
+		ods.swap(it->second);
+		_cached_paths_by_link.erase(it);
+		for( const auto& od : ods ) {
+			auto it_source = _look_up_paths.find(od.first);
+			if( it_source == _look_up_paths.end() ) continue;
+			auto it_dest = it_source->second.find(od.second);
+			if( it_dest == it_source->second.end() ) continue;
+			for( const auto& path_link : it_dest->second ) {
+				auto it_link = _cached_paths_by_link.find(path_link);
+				if( it_link == _cached_paths_by_link.end() ) continue;
+				it_link->second.erase(od);
+				if( it_link->second.empty() == true ) _cached_paths_by_link.erase(it_link);
+			}
+			it_source->second.erase(it_dest);
+			n_paths++;
 		}
+	}
+
+	// Destination trees and partition overlay, only where affected
+	vector<int> links_index;
+	for( const auto& l : links ) links_index.push_back(_network.getLinkIndex(l));
 
+	// ... the free flow time of the links of the table having changed
+	if( _link_times.isBuilt() == true ) {
+		_link_times.getTimes(_network.getLinksTime(), _link_costs.write());
+		_link_costs.publish();
 	}
 
-	// Recording aggregate data
+	boost::mpi::communicator* comm = RepastProcess::instance()->getCommunicator();
+	unsigned int n_trees = 0, n_partitions = 0;
+	if( _dest_trees.size() > 0 )         n_trees      = _dest_trees.updateLinks(_network, links_index, getCurrentLinksTime(), *comm);
+	if( _network.getPartition() >= 0 ) n_partitions = _overlay.updateLinks(_network, links_index, *comm);
+	if( _use_route_cache == true )       n_paths     += _route_cache.invalidateLinks(set<int>(links_index.begin(), links_index.end()));
+
+	// ... reported once for every process (the trees and partitions counts being global already)
+	unsigned int n_paths_total = 0, n_links_max = 0;
+	boost::mpi::reduce(*comm, n_paths, n_paths_total, std::plus<unsigned int>(), 0);
+	boost::mpi::reduce(*comm, (unsigned int)links.size(), n_links_max, boost::mpi::maximum<unsigned int>(), 0);
+	if( _proc == 0 ) cout << "INFO: routing state invalidated on " << n_links_max << " links: " << n_paths_total << " cached paths removed, "
+		                  << n_trees << " destination trees and " << n_partitions << " partitions shortcuts recomputed" << endl;
 
-	this->_total_agents.setData(this->agents->size());
-	this->_data_collection->record();
+}
 
-	// Synchronizing agents states (eventually moving them to a new process)
 
-	this->synch_agents();
+void Model::writePositions() {
+
+	vector<PositionRecord> records;
+	records.reserve(agents->size());
+
+	auto it = (*agents).localBegin();
+	while( it != (*agents).localEnd() ) {
+		if( (*it)->isEnRoute() == true ) {
+			// ... progress from the time left on the link, an agent at a node being at the end of its link
+			const Link& lnk = _network.getLinks().at( (*it)->getCurLink() );
+			float progress = 1.0f;
+			if( (*it)->isAtNode() == false ) progress = 1.0f - (*it)->getRemainingTime() / lnk.timeOnLink();
+			// ... an agent on a super link being located on one of its original links
+			float link_progress;
+			std::string id_link = _network.getOriginalLinkAt( (*it)->getCurLink(), max(0.0f, min(1.0f, progress)), link_progress );
+			PositionRecord rec = { (int32_t)(*it)->getId().id(), (int32_t)_positions_links.at(id_link), max(0.0f, min(1.0f, link_progress)) };
+			records.push_back(rec);
+		}
+		it++;
+	}
+
+	_positions.addFrame(_time, records);
 
 }
 
@@ -828,6 +2057,9 @@ void Model::writeLinksState() {
 	unsigned int n_time_intervals = 1440 / this->_time_interval_records;                          // 1440 minutes in a day
 	unsigned int n_time_intervals_snapshot = 1440 / this->_time_interval_records_snapshots;
 
+	// Every process recorded every link, process 0 writes their sum
+	if( _decomposition == Decomposition::AGENTS ) reduceLinksRecords();
+
 	// Opening output files
 
 	ofstream file_output_flows;
@@ -889,16 +2121,21 @@ void Model::writeLinksState() {
 
 			for( auto lnk : this->_links_load_over_time ) {
 
-				file_output_flows << lnk.first;
-				file_output_props << lnk.first;
+				// every agent entering a super link goes through each of its original links
+				for( const auto& orig : _network.getOriginalLinks(lnk.first) ) {
 
-				for( unsigned int t = 0; t < lnk.second.capacity(); ++t ) {
-					file_output_flows << ";" << lnk.second.at(t);
-					file_output_props << ";" << (float)lnk.second.at(t) / this->_network.getLinks().at(lnk.first).getCapacity();
-				}
+					file_output_flows << orig;
+					file_output_props << orig;
+
+					for( unsigned int t = 0; t < lnk.second.capacity(); ++t ) {
+						file_output_flows << ";" << lnk.second.at(t);
+						file_output_props << ";" << (float)lnk.second.at(t) / this->_network.getOriginalLink(orig).getCapacity();
+					}
 
-				file_output_flows << endl;
-				file_output_props << endl;
+					file_output_flows << endl;
+					file_output_props << endl;
+
+				}
 
 			}
 
@@ -912,7 +2149,7 @@ void Model::writeLinksState() {
 
 				for( unsigned int t = 0; t < lnk.second.capacity(); ++t ) {
 					file_output_flows_snapshot << ";" << lnk.second.at(t);
-					file_output_props_snapshot << ";" << (float)lnk.second.at(t) / this->_network.getLinks().at(lnk.first).getCapacity();
+					file_output_props_snapshot << ";" << (float)lnk.second.at(t) / this->_network.getOriginalLink(lnk.first).getCapacity();
 				}
 
 				file_output_flows_snapshot << endl;
@@ -1012,6 +2249,9 @@ void Model::constructMapNodeProcess() {
 
 	vector<map<std::string, int>> result_gather;
 
+	// ... a sharded network giving the owners of its nodes (see getNodeProcess)
+	if( _network.getPartition() >= 0 ) return;
+
 	// gathering data from every process
 	boost::mpi::all_gather(*comm, _map_node_process, result_gather);
 
@@ -1040,6 +2280,74 @@ void Model::constructMapNodeProcess() {
 }
 
 
+void Model::writeStepStats() {
+
+	boost::mpi::communicator* comm = RepastProcess::instance()->getCommunicator();
+
+	long long misses = _step_misses.isOpen() == true ? _step_misses.getTotal() : -1;
+	unsigned long long totals[2] = { _n_agents_stepped, _n_link_switches };
+	unsigned long long sums[2];
+	boost::mpi::reduce(*comm, totals, 2, sums, std::plus<unsigned long long>(), 0);
+	// ... the cache misses only if counted by every process
+	long long misses_total = boost::mpi::all_reduce(*comm, misses, boost::mpi::minimum<long long>());
+	if( misses_total >= 0 ) boost::mpi::reduce(*comm, misses, misses_total, std::plus<long long>(), 0);
+
+	if( _proc == 0 && sums[0] > 0 ) {
+		cout << "INFO: agents updates " << ( _reorder_interval > 0 ? "reordered every " + to_string(_reorder_interval) + " steps" : "in context order" )
+			 << ": " << (double)sums[1] / sums[0] << " links switches";
+		if( misses_total >= 0 ) cout << ", " << (double)misses_total / sums[0] << " cache misses";
+		cout << " per agent update" << endl;
+	}
+
+}
+
+
+void Model::writeWarmStart() {
+
+	boost::mpi::communicator* comm = RepastProcess::instance()->getCommunicator();
+
+	ofstream file_output_warm;
+	string file_out = "../output/warm_start.csv";
+
+	if( this->_proc == 0 ) {
+		file_output_warm.open(file_out.c_str(), ios::out);
+		file_output_warm << "AGENT_ID;LINK;REMAINING_TIME;TRIPS" << endl;
+		file_output_warm.close();
+	}
+
+	// Loop over the process, only one process at a time writing its agents on the road
+
+	for( int p = 0; p < comm->size(); p++ ) {
+
+		comm->barrier();
+		if( comm->rank() == p ) {
+
+			file_output_warm.open(file_out.c_str(), ios::app);
+
+			auto it = (*agents).localBegin();
+			while( it != (*agents).localEnd() ) {
+				if( (*it)->isEnRoute() == true ) {
+					// ... an agent on a super link is put on its last original link, reaching the end of the chain on time
+					std::string id_link = (*it)->getCurLink();
+					if( _network.isChain(id_link) == true ) id_link = _network.getOriginalLinks(id_link).back();
+					file_output_warm << (*it)->getId().id() << ";" << id_link << ";" << (*it)->getRemainingTime();
+					for( const auto& t : (*it)->getTrips() ) {
+						file_output_warm << ";" << t.getIdOrigin() << ";" << t.getIdDestination() << ";" << t.getStartingTime();
+					}
+					file_output_warm << endl;
+				}
+				it++;
+			}
+
+			file_output_warm.close();
+
+		}
+
+	}
+
+}
+
+
 void Model::writeAgentFitness() {
 
 	boost::mpi::communicator* comm = RepastProcess::instance()->getCommunicator();
@@ -1073,12 +2381,19 @@ void Model::writeAgentFitness() {
 
 			file_output_fitness.open(file_out.c_str(),ios::app);
 
-			for( const auto &agt : this->_map_agent_fitness ) {
+			for( unsigned int i = 0; i < this->_finished_agents.size(); i++ ) {
 
-				file_output_fitness << agt.first << ";" << agt.second << endl;
+				file_output_fitness << this->_finished_agents[i] << ";" << this->_finished_fitness[i] << endl;
 
 			}
 
+			// ... and of the agents still in the simulation having performed a trip
+			auto it = (*agents).localBegin();
+			while( it != (*agents).localEnd() ) {
+				if( (*it)->getFitness() >= 0.0f ) file_output_fitness << (*it)->getId().id() << ";" << (*it)->getFitness() << endl;
+				it++;
+			}
+
 			file_output_fitness.close();
 
 		}
@@ -1109,8 +2424,18 @@ void Model::writeOutputsMoves(int id, std::string link_id, float time_entering_l
 	string file_out = "../output/moves_proc_" + to_string(_proc) + ".csv";
 	file_output_moves.open(file_out.c_str(), ios::app);
 
-	// writing the data
-	file_output_moves << id << ";" << link_id << ";" << time_entering_link << ";" << time_on_link << ";" <<  path_id << ";" << link_id_on_path << endl;
+	// writing the data, a super link being split into its original links proportionally to their free flow time
+	if( _network.isChain(link_id) == true ) {
+		float ff_time = _network.getLinks().at(link_id).getFreeFlowTime();
+		for( const auto& orig : _network.getOriginalLinks(link_id) ) {
+			float time_on_orig = time_on_link * _network.getOriginalLink(orig).getFreeFlowTime() / ff_time;
+			file_output_moves << id << ";" << orig << ";" << time_entering_link << ";" << time_on_orig << ";" <<  path_id << ";" << link_id_on_path << endl;
+			time_entering_link += time_on_orig;
+		}
+	}
+	else {
+		file_output_moves << id << ";" << link_id << ";" << time_entering_link << ";" << time_on_link << ";" <<  path_id << ";" << link_id_on_path << endl;
+	}
 
 	// closing the file
 	file_output_moves.close();
@@ -11,6 +11,10 @@
 #include "../include/Network.hpp"
 #include "repast_hpc/RepastProcess.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 using namespace repast;
 
@@ -42,6 +46,10 @@ vector<std::string> Network::computePath(std::string source_id, std::string dest
 	map<std::string, std::string> prec;                                            // map giving the precedent node on the shortest path
 	std::string curr_node = source_id;                                      // current node found by Dijkstra algorithm
 
+	// No search if the destination cannot be reached
+
+	if( isReachable(source_id, dest_id) == false ) return result;
+
 	// Initialization
 
 	FibonacciHeap<std::string,float> Q;                                     // Fibonacci heap
@@ -149,7 +157,7 @@ vector<std::string> Network::computePathAStar(std::string source_id, std::string
 	std::string curr_node = source_id;                                // current node found by Dijkstra algorithm
 
 
-	if( source_id == dest_id ) {
+	if( source_id == dest_id || isReachable(source_id, dest_id) == false ) {
 		return result;
 	}
 
@@ -219,6 +227,956 @@ vector<std::string> Network::computePathAStar(std::string source_id, std::string
 
 }
 
+vector<std::string> Network::computePath(const std::string& source_id, const std::string& dest_id, const vector<float>& cost) const {
+
+	vector<std::string> result;
+
+	if( source_id == dest_id || isReachable(source_id, dest_id) == false ) return result;
+
+	int source   = _node_index.at(source_id);
+	int dest     = _node_index.at(dest_id);
+	int n_nodes  = (int)_node_ids.size();
+
+	vector<float> dist(n_nodes, std::numeric_limits<float>::max());
+	vector<int>   pred(n_nodes, -1);                                     // last link of the path to every node
+
+	FibonacciHeap<int,float> Q;                                          // Fibonacci heap of the tentative nodes
+	vector<FibonacciHeapNode<int,float>*> Q_nodes(n_nodes, NULL);        // pointers to the nodes of the F-heap
+	vector<bool> closed(n_nodes, false);                                 // nodes already settled
+
+	dist[source] = 0.0f;
+	Q_nodes[source] = Q.insert(source, 0.0f);
+
+	// Dijkstra main loop, up to the destination
+	while( Q.empty() == false ) {
+
+		int   u = Q.minimum()->data();
+		float d = Q.minimum()->key();
+		Q.deletemin();
+		closed[u] = true;
+		if( u == dest ) break;
+
+		for( int k = _out_first[u]; k < _out_first[u + 1]; k++ ) {
+
+			int l = _out_links[k];
+			int v = _link_end[l];
+			if( closed[v] == true ) continue;
+
+			float w = d + cost[l];
+			if( w < dist[v] ) {
+				dist[v] = w;
+				pred[v] = l;
+				if( Q_nodes[v] == NULL ) Q_nodes[v] = Q.insert(v, w);
+				else                     Q.decreaseKey(Q_nodes[v], w);
+			}
+
+		}
+
+	}
+
+	// reconstructing the path, from its last link
+	for( int v = dest; v != source; v = _link_start[pred[v]] ) result.push_back(_link_ids[pred[v]]);
+
+	return result;
+
+}
+
+std::string Network::placeIndex() {
+
+	// Any search reads the arrays at random from any node, whatever the thread: their pages are interleaved
+	for( auto a : { &_link_start, &_link_end, &_out_first, &_out_links, &_in_first, &_in_links } ) Placement::interleave(*a);
+
+	return Placement::describePages(_out_links.data(), _out_links.size() * sizeof(int));
+
+}
+
+void Network::buildIndex() {
+
+	_node_ids.clear();
+	_link_ids.clear();
+	_node_index.clear();
+	_link_index.clear();
+
+	// Temporary numbering following the order of the ids
+	vector<std::string> ids_nodes;
+	unordered_map<std::string, int> tmp_index;
+	for( const auto& n : _Nodes ) {
+		tmp_index[n.first] = (int)ids_nodes.size();
+		ids_nodes.push_back(n.first);
+	}
+
+	int n_nodes = (int)ids_nodes.size();
+	int n_links = (int)_Links.size();
+
+	// Nodes order
+	vector<int> order;
+	if( _node_order == NodeOrder::HILBERT )  order = hilbertOrder(ids_nodes);
+	else if( _node_order == NodeOrder::RCM ) order = rcmOrder(ids_nodes, tmp_index);
+	else {
+		order.resize(n_nodes);
+		for( int n = 0; n < n_nodes; n++ ) order[n] = n;
+	}
+
+	for( int n : order ) {
+		_node_index[ids_nodes[n]] = (int)_node_ids.size();
+		_node_ids.push_back(ids_nodes[n]);
+	}
+
+	// Links ordered by source node, then by id
+	vector<pair<int, const Link*>> links;
+	links.reserve(n_links);
+	for( const auto& lnk : _Links ) links.push_back(make_pair(_node_index.at(lnk.second.getStartNodeId()), &lnk.second));
+	stable_sort(links.begin(), links.end(), [](const pair<int, const Link*>& a, const pair<int, const Link*>& b) {
+		return a.first < b.first;
+	});
+
+	_link_start.assign(n_links, 0);
+	_link_end.assign(n_links, 0);
+	_out_first.assign(n_nodes + 1, 0);
+	_in_first.assign(n_nodes + 1, 0);
+
+	for( int l = 0; l < n_links; l++ ) {
+		_link_index[links[l].second->getId()] = l;
+		_link_ids.push_back(links[l].second->getId());
+		_link_start[l] = links[l].first;
+		_link_end[l]   = _node_index.at(links[l].second->getEndNodeId());
+		_out_first[_link_start[l] + 1]++;
+		_in_first[_link_end[l] + 1]++;
+	}
+
+	// Compressed adjacency (links of a node keep the link index order)
+	for( int n = 0; n < n_nodes; n++ ) {
+		_out_first[n + 1] += _out_first[n];
+		_in_first[n + 1]  += _in_first[n];
+	}
+
+	_out_links.assign(n_links, 0);
+	_in_links.assign(n_links, 0);
+	vector<int> out_pos(_out_first.begin(), _out_first.end() - 1);
+	vector<int> in_pos(_in_first.begin(), _in_first.end() - 1);
+	for( int l = 0; l < n_links; l++ ) {
+		_out_links[out_pos[_link_start[l]]++] = l;
+		_in_links[in_pos[_link_end[l]]++]     = l;
+	}
+
+	// Link between every pair of nodes (the lowest index one for parallel links)
+	_link_between.clear();
+	_link_between.reserve(n_links);
+	for( int l = 0; l < n_links; l++ ) _link_between.insert(make_pair( (long)_link_start[l] * n_nodes + _link_end[l], l ));
+
+	computeComponents();
+
+}
+
+
+void Network::computeComponents() {
+
+	int n_nodes = (int)_node_ids.size();
+
+	_component.assign(n_nodes, -1);
+	_component_size.clear();
+
+	// Iterative Tarjan's algorithm, the call stack holding (node, next outgoing link position)
+	vector<int>  num(n_nodes, -1), low(n_nodes, 0);
+	vector<bool> on_stack(n_nodes, false);
+	vector<int>  stack;
+	vector<pair<int,int>> calls;
+	int counter = 0;
+
+	for( int s = 0; s < n_nodes; s++ ) {
+
+		if( num[s] >= 0 ) continue;
+
+		num[s] = low[s] = counter++;
+		stack.push_back(s);
+		on_stack[s] = true;
+		calls.push_back(make_pair(s, _out_first[s]));
+
+		while( calls.empty() == false ) {
+
+			int v = calls.back().first;
+
+			if( calls.back().second < _out_first[v + 1] ) {
+				int w = _link_end[_out_links[calls.back().second++]];
+				if( num[w] < 0 ) {
+					num[w] = low[w] = counter++;
+					stack.push_back(w);
+					on_stack[w] = true;
+					calls.push_back(make_pair(w, _out_first[w]));
+				}
+				else if( on_stack[w] == true ) {
+					low[v] = min(low[v], num[w]);
+				}
+				continue;
+			}
+
+			// ... every link of v explored, v being the root of a component
+			if( low[v] == num[v] ) {
+				int comp = (int)_component_size.size();
+				_component_size.push_back(0);
+				int w;
+				do {
+					w = stack.back();
+					stack.pop_back();
+					on_stack[w]   = false;
+					_component[w] = comp;
+					_component_size[comp]++;
+				} while( w != v );
+			}
+
+			calls.pop_back();
+			if( calls.empty() == false ) low[calls.back().first] = min(low[calls.back().first], low[v]);
+
+		}
+
+	}
+
+	// Condensed graph
+	int n_comp = (int)_component_size.size();
+	vector<pair<int,int>> edges;
+	for( unsigned int l = 0; l < _link_start.size(); l++ ) {
+		int cs = _component[_link_start[l]];
+		int ce = _component[_link_end[l]];
+		if( cs != ce ) edges.push_back(make_pair(cs, ce));
+	}
+	sort(edges.begin(), edges.end());
+	edges.erase(unique(edges.begin(), edges.end()), edges.end());
+
+	_comp_first.assign(n_comp + 1, 0);
+	_comp_succ.assign(edges.size(), 0);
+	for( unsigned int e = 0; e < edges.size(); e++ ) {
+		_comp_first[edges[e].first + 1]++;
+		_comp_succ[e] = edges[e].second;
+	}
+	for( int c = 0; c < n_comp; c++ ) _comp_first[c + 1] += _comp_first[c];
+
+}
+
+
+bool Network::isReachable(const std::string& source_id, const std::string& dest_id) const {
+
+	if( _partition >= 0 ) return true;
+
+	int cs = _component[_node_index.at(source_id)];
+	int cd = _component[_node_index.at(dest_id)];
+	if( cs == cd ) return true;
+	if( cd > cs )  return false;
+
+	// Search of the condensed graph, only through the components numbered after the destination one
+	vector<int>  stack(1, cs);
+	vector<bool> seen(cs - cd + 1, false);
+	seen[cs - cd] = true;
+	while( stack.empty() == false ) {
+		int c = stack.back();
+		stack.pop_back();
+		for( int e = _comp_first[c]; e < _comp_first[c + 1]; e++ ) {
+			int succ = _comp_succ[e];
+			if( succ == cd ) return true;
+			if( succ > cd && seen[succ - cd] == false ) {
+				seen[succ - cd] = true;
+				stack.push_back(succ);
+			}
+		}
+	}
+
+	return false;
+
+}
+
+
+unsigned int Network::restrictToLargestComponent() {
+
+	int largest = getLargestComponent();
+
+	map<std::string, Link> links;
+	for( const auto& lnk : _Links ) {
+		if( getComponent(lnk.second.getStartNodeId()) == largest && getComponent(lnk.second.getEndNodeId()) == largest ) links.insert(lnk);
+	}
+
+	map<std::string, Node> nodes;
+	for( const auto& n : _Nodes ) {
+		if( getComponent(n.first) != largest ) continue;
+		Node nde = n.second;
+		vector<std::string> links_out;
+		for( const auto& l : nde.getLinksOutId() ) if( links.count(l) == 1 ) links_out.push_back(l);
+		nde.setLinksOutId(links_out);
+		nodes.insert(make_pair(n.first, nde));
+	}
+
+	unsigned int n_removed = (unsigned int)( _Nodes.size() - nodes.size() );
+	_Links.swap(links);
+	_Nodes.swap(nodes);
+
+	return n_removed;
+
+}
+
+
+unsigned long Network::hilbertKey(double x, double y, double min_x, double min_y, double scale) {
+
+	const unsigned int side = 1u << 16;                                  // resolution of the curve
+
+	unsigned int cx = (unsigned int)min( max( ( x - min_x ) * scale, 0.0 ), (double)( side - 1 ) );
+	unsigned int cy = (unsigned int)min( max( ( y - min_y ) * scale, 0.0 ), (double)( side - 1 ) );
+
+	unsigned long d = 0;
+	for( unsigned int s = side / 2; s > 0; s /= 2 ) {
+		unsigned int rx = ( cx & s ) > 0;
+		unsigned int ry = ( cy & s ) > 0;
+		d += (unsigned long)s * s * ( ( 3 * rx ) ^ ry );
+		if( ry == 0 ) {
+			if( rx == 1 ) {
+				cx = side - 1 - cx;
+				cy = side - 1 - cy;
+			}
+			swap(cx, cy);
+		}
+	}
+
+	return d;
+
+}
+
+
+double Network::hilbertScale(double min_x, double max_x, double min_y, double max_y) {
+
+	return ( (1u << 16) - 1 ) / max(max(max_x - min_x, max_y - min_y), 1e-9);
+
+}
+
+
+vector<int> Network::hilbertOrder(const vector<std::string>& ids_nodes) const {
+
+	double min_x = std::numeric_limits<double>::max(), max_x = -std::numeric_limits<double>::max();
+	double min_y = std::numeric_limits<double>::max(), max_y = -std::numeric_limits<double>::max();
+	for( const auto& n : _Nodes ) {
+		min_x = min(min_x, n.second.getXData());
+		max_x = max(max_x, n.second.getXData());
+		min_y = min(min_y, n.second.getYData());
+		max_y = max(max_y, n.second.getYData());
+	}
+	double scale = hilbertScale(min_x, max_x, min_y, max_y);
+
+	// Position of every node along the curve (real coordinates, not the shuffled ones)
+	vector<pair<unsigned long, int>> keys;
+	keys.reserve(ids_nodes.size());
+	for( unsigned int n = 0; n < ids_nodes.size(); n++ ) {
+		const Node& nde = _Nodes.at(ids_nodes[n]);
+		keys.push_back(make_pair(hilbertKey(nde.getXData(), nde.getYData(), min_x, min_y, scale), (int)n));
+	}
+
+	sort(keys.begin(), keys.end());
+
+	vector<int> order;
+	order.reserve(keys.size());
+	for( const auto& k : keys ) order.push_back(k.second);
+
+	return order;
+
+}
+
+
+vector<int> Network::rcmOrder(const vector<std::string>& ids_nodes, const unordered_map<std::string, int>& tmp_index) const {
+
+	int n_nodes = (int)ids_nodes.size();
+
+	// Undirected adjacency
+	vector<vector<int>> adj(n_nodes);
+	for( const auto& lnk : _Links ) {
+		int u = tmp_index.at(lnk.second.getStartNodeId());
+		int v = tmp_index.at(lnk.second.getEndNodeId());
+		if( u == v ) continue;
+		adj[u].push_back(v);
+		adj[v].push_back(u);
+	}
+	for( auto& a : adj ) {
+		sort(a.begin(), a.end());
+		a.erase(unique(a.begin(), a.end()), a.end());
+	}
+
+	// Nodes by increasing degree, the first unvisited one starting every component
+	vector<int> by_degree(n_nodes);
+	for( int n = 0; n < n_nodes; n++ ) by_degree[n] = n;
+	stable_sort(by_degree.begin(), by_degree.end(), [&adj](int a, int b) { return adj[a].size() < adj[b].size(); });
+
+	vector<int>  order;
+	vector<bool> visited(n_nodes, false);
+	order.reserve(n_nodes);
+
+	// Cuthill-McKee breadth first search, neighbours visited by increasing degree
+	for( int root : by_degree ) {
+
+		if( visited[root] == true ) continue;
+		visited[root] = true;
+		size_t head = order.size();
+		order.push_back(root);
+
+		while( head < order.size() ) {
+			int u = order[head++];
+			vector<int> next;
+			for( int v : adj[u] ) {
+				if( visited[v] == false ) {
+					visited[v] = true;
+					next.push_back(v);
+				}
+			}
+			stable_sort(next.begin(), next.end(), [&adj](int a, int b) { return adj[a].size() < adj[b].size(); });
+			order.insert(order.end(), next.begin(), next.end());
+		}
+
+	}
+
+	reverse(order.begin(), order.end());
+
+	return order;
+
+}
+
+
+bool Network::isValidPath(const vector<std::string>& path, const std::string& source_id, const std::string& dest_id) const {
+
+	if( path.empty() == true ) return source_id == dest_id;
+
+	// Links are stored from the last one to the first one
+	std::string cur_node = source_id;
+	for( auto it = path.rbegin(); it != path.rend(); it++ ) {
+		auto lnk = _Links.find(*it);
+		if( lnk == _Links.end() || lnk->second.getStartNodeId() != cur_node ) return false;
+		cur_node = lnk->second.getEndNodeId();
+	}
+
+	return cur_node == dest_id;
+
+}
+
+
+vector<unsigned int> Network::getLinksNAgents() const {
+
+	vector<unsigned int> result(_link_ids.size(), 0);
+	for( const auto& lnk : _Links ) result[_link_index.at(lnk.first)] = lnk.second.getNAgents();
+
+	return result;
+
+}
+
+
+vector<float> Network::getLinksTime(const vector<unsigned int>& n_agents) const {
+
+	vector<float> result(_link_ids.size(), 0.0f);
+
+	for( const auto& lnk : _Links ) {
+		int l = _link_index.at(lnk.first);
+		if( n_agents.empty() ) result[l] = lnk.second.getFreeFlowTime();
+		else                   result[l] = lnk.second.timeOnLink(n_agents[l]);
+	}
+
+	return result;
+
+}
+
+
+void Network::computeTreeToDestination(int dest_index, const vector<float>& cost, vector<int>& next_link) const {
+
+	vector<float> dist;
+	computeTreeToDestination(dest_index, cost, next_link, dist);
+
+}
+
+
+void Network::computeTreeToDestination(int dest_index, const vector<float>& cost, vector<int>& next_link,
+		                               vector<float>& dist) const {
+
+	int n_nodes = (int)_node_ids.size();
+
+	next_link.assign(n_nodes, -1);
+	dist.assign(n_nodes, std::numeric_limits<float>::max());             // distance to the destination
+
+	FibonacciHeap<int,float> Q;                                          // Fibonacci heap of the tentative nodes
+	vector<FibonacciHeapNode<int,float>*> Q_nodes(n_nodes, NULL);        // pointers to the nodes of the F-heap
+	vector<bool> closed(n_nodes, false);                                 // nodes already settled
+
+	dist[dest_index] = 0.0f;
+	Q_nodes[dest_index] = Q.insert(dest_index, 0.0f);
+
+	// Dijkstra on the reversed graph
+	while( Q.empty() == false ) {
+
+		int   v = Q.minimum()->data();
+		float d = Q.minimum()->key();
+		Q.deletemin();
+		closed[v] = true;
+
+		// ... relaxing every link entering v
+		for( int k = _in_first[v]; k < _in_first[v + 1]; k++ ) {
+
+			int l = _in_links[k];
+			int u = _link_start[l];
+			if( closed[u] == true ) continue;
+
+			float w = d + cost[l];
+			if( w < dist[u] ) {
+				dist[u] = w;
+				if( Q_nodes[u] == NULL ) Q_nodes[u] = Q.insert(u, w);
+				else                     Q.decreaseKey(Q_nodes[u], w);
+			}
+
+		}
+
+	}
+
+	settleNextLinks(dest_index, cost, dist, next_link);
+
+}
+
+
+void Network::computeTree(int source_index, const vector<float>& cost, vector<float>& dist, vector<int>& pred) const {
+
+	int n_nodes = (int)_node_ids.size();
+
+	dist.assign(n_nodes, std::numeric_limits<float>::max());
+
+	FibonacciHeap<int,float> Q;                                          // Fibonacci heap of the tentative nodes
+	vector<FibonacciHeapNode<int,float>*> Q_nodes(n_nodes, NULL);        // pointers to the nodes of the F-heap
+	vector<bool> closed(n_nodes, false);                                 // nodes already settled
+
+	dist[source_index] = 0.0f;
+	Q_nodes[source_index] = Q.insert(source_index, 0.0f);
+
+	// Dijkstra main loop
+	while( Q.empty() == false ) {
+
+		int   u = Q.minimum()->data();
+		float d = Q.minimum()->key();
+		Q.deletemin();
+		closed[u] = true;
+
+		for( int k = _out_first[u]; k < _out_first[u + 1]; k++ ) {
+
+			int l = _out_links[k];
+			int v = _link_end[l];
+			if( closed[v] == true ) continue;
+
+			float w = d + cost[l];
+			if( w < dist[v] ) {
+				dist[v] = w;
+				if( Q_nodes[v] == NULL ) Q_nodes[v] = Q.insert(v, w);
+				else                     Q.decreaseKey(Q_nodes[v], w);
+			}
+
+		}
+
+	}
+
+	settlePredecessors(source_index, cost, dist, pred);
+
+}
+
+
+void Network::computeTreeDeltaStepping(int source_index, const vector<float>& cost, vector<float>& dist,
+		                               vector<int>& pred, float delta) const {
+
+	deltaSteppingDistances(source_index, cost, dist, delta, false);
+	settlePredecessors(source_index, cost, dist, pred);
+
+}
+
+
+void Network::computeTreeToDestinationDeltaStepping(int dest_index, const vector<float>& cost, vector<int>& next_link,
+		                                            vector<float>& dist, float delta) const {
+
+	deltaSteppingDistances(dest_index, cost, dist, delta, true);
+	settleNextLinks(dest_index, cost, dist, next_link);
+
+}
+
+
+void Network::deltaSteppingDistances(int root_index, const vector<float>& cost, vector<float>& dist,
+		                             float delta, bool reverse) const {
+
+	int n_nodes = (int)_node_ids.size();
+	if( delta <= 0.0f ) delta = deltaSteppingWidth(cost);
+
+	// links leaving a node, or entering it on the reversed graph
+	const PlacedVector<int>& first     = reverse == true ? _in_first   : _out_first;
+	const PlacedVector<int>& adjacent  = reverse == true ? _in_links   : _out_links;
+	const PlacedVector<int>& other_end = reverse == true ? _link_start : _link_end;
+
+	int n_threads = 1;
+#ifdef _OPENMP
+	n_threads = omp_get_max_threads();
+#endif
+
+	dist.assign(n_nodes, std::numeric_limits<float>::max());
+
+	vector<vector<int>> buckets(1);                                      // buckets of tentative nodes (may contain stale entries)
+	vector<int> frontier_stamp(n_nodes, -1);                             // last phase in which a node was in the frontier
+	vector<int> settled_stamp(n_nodes, -1);                              // last bucket in which a node was settled
+
+	// relaxation requests (node, distance), per emitting thread and per owner thread
+	vector<vector<vector<pair<int,float>>>> requests(n_threads, vector<vector<pair<int,float>>>(n_threads));
+	vector<vector<int>> improved(n_threads);                             // nodes improved by every owner thread
+
+	auto bucket_of = [delta](float d) { return (size_t)(d / delta); };
+
+	// Relaxing the light or heavy links of a set of nodes. Requests are generated in parallel,
+	// then every thread applies the requests for the nodes it owns (node % n_threads).
+	auto relax = [&](const vector<int>& nodes, bool light) {
+
+#pragma omp parallel num_threads(n_threads)
+		{
+			int t = 0;
+#ifdef _OPENMP
+			t = omp_get_thread_num();
+#endif
+			for( auto& r : requests[t] ) r.clear();
+
+#pragma omp for schedule(dynamic, 64)
+			for( size_t k = 0; k < nodes.size(); k++ ) {
+				int   u  = nodes[k];
+				float du = dist[u];
+				for( int j = first[u]; j < first[u + 1]; j++ ) {
+					int l = adjacent[j];
+					if( ( cost[l] <= delta ) != light ) continue;
+					int   v  = other_end[l];
+					float dv = du + cost[l];
+					if( dv < dist[v] ) requests[t][v % n_threads].push_back(make_pair(v, dv));
+				}
+			}
+
+			improved[t].clear();
+			for( int e = 0; e < n_threads; e++ ) {
+				for( const auto& r : requests[e][t] ) {
+					if( r.second < dist[r.first] ) {
+						dist[r.first] = r.second;
+						improved[t].push_back(r.first);
+					}
+				}
+			}
+		}
+
+		for( const auto& imp : improved ) {
+			for( int v : imp ) {
+				size_t b = bucket_of(dist[v]);
+				if( b >= buckets.size() ) buckets.resize(b + 1);
+				buckets[b].push_back(v);
+			}
+		}
+
+	};
+
+	dist[root_index] = 0.0f;
+	buckets[0].push_back(root_index);
+
+	int phase = 0;
+	for( size_t i = 0; i < buckets.size(); i++ ) {
+
+		vector<int> settled;                                             // nodes removed from bucket i
+
+		// ... light links phases, nodes may come back in the current bucket
+		while( buckets[i].empty() == false ) {
+
+			vector<int> frontier;
+			for( int v : buckets[i] ) {
+				if( bucket_of(dist[v]) != i || frontier_stamp[v] == phase ) continue;
+				frontier_stamp[v] = phase;
+				frontier.push_back(v);
+				if( settled_stamp[v] != (int)i ) {
+					settled_stamp[v] = (int)i;
+					settled.push_back(v);
+				}
+			}
+			buckets[i].clear();
+			phase++;
+
+			relax(frontier, true);
+
+		}
+
+		// ... heavy links, settled once the bucket is empty
+		relax(settled, false);
+
+	}
+
+}
+
+
+float Network::deltaSteppingWidth(const vector<float>& cost) const {
+
+	if( cost.empty() || _node_ids.empty() ) return 1.0f;
+
+	// links made prohibitive (see computePath avoiding a link) are ignored
+	double sum_cost = 0.0;
+	long   n_costs  = 0;
+	float  min_cost = std::numeric_limits<float>::max();
+	for( float c : cost ) {
+		if( c >= std::numeric_limits<float>::max() * 0.5f ) continue;
+		sum_cost += c;
+		n_costs++;
+		if( c > 0.0f && c < min_cost ) min_cost = c;
+	}
+	if( n_costs == 0 ) return 1.0f;
+
+	double mean_cost   = sum_cost / n_costs;
+	double mean_degree = (double)cost.size() / _node_ids.size();
+	float  delta       = (float)(mean_cost * mean_degree);
+
+	if( min_cost < std::numeric_limits<float>::max() && delta < min_cost ) delta = min_cost;
+	if( delta <= 0.0f ) delta = 1.0f;
+
+	return delta;
+
+}
+
+
+void Network::settlePredecessors(int source_index, const vector<float>& cost, const vector<float>& dist, vector<int>& pred) const {
+
+	int n_nodes = (int)_node_ids.size();
+	pred.assign(n_nodes, -1);
+
+#pragma omp parallel for schedule(static)
+	for( int v = 0; v < n_nodes; v++ ) {
+		if( v == source_index || dist[v] == std::numeric_limits<float>::max() ) continue;
+		for( int k = _in_first[v]; k < _in_first[v + 1]; k++ ) {
+			int l = _in_links[k];
+			int u = _link_start[l];
+			if( dist[u] != std::numeric_limits<float>::max() && dist[u] + cost[l] == dist[v] ) {
+				pred[v] = l;                                             // incoming links are sorted by index
+				break;
+			}
+		}
+	}
+
+}
+
+
+void Network::settleNextLinks(int dest_index, const vector<float>& cost, const vector<float>& dist, vector<int>& next_link) const {
+
+	int n_nodes = (int)_node_ids.size();
+	next_link.assign(n_nodes, -1);
+
+#pragma omp parallel for schedule(static)
+	for( int u = 0; u < n_nodes; u++ ) {
+		if( u == dest_index || dist[u] == std::numeric_limits<float>::max() ) continue;
+		for( int k = _out_first[u]; k < _out_first[u + 1]; k++ ) {
+			int l = _out_links[k];
+			int v = _link_end[l];
+			if( dist[v] != std::numeric_limits<float>::max() && dist[v] + cost[l] == dist[u] ) {
+				next_link[u] = l;                                        // outgoing links are sorted by index
+				break;
+			}
+		}
+	}
+
+}
+
+
+unsigned int Network::contractChains(const vector<bool>& protected_nodes) {
+
+	int n_nodes = (int)_node_ids.size();
+	int n_links = (int)_link_ids.size();
+
+	// Finding the chain nodes and the link continuing every link entering them
+
+	vector<bool> chain_node(n_nodes, false);
+	vector<int>  next_in_chain(n_links, -1);
+
+	for( int v = 0; v < n_nodes; v++ ) {
+
+		if( protected_nodes[v] == true ) continue;
+
+		int n_in  = _in_first[v + 1] - _in_first[v];
+		int n_out = _out_first[v + 1] - _out_first[v];
+		if( n_in != n_out || n_in < 1 || n_in > 2 ) continue;
+
+		// ... every entering link must be continued by exactly one leaving link, not going back
+		bool is_chain = true;
+		vector<int> next(n_in, -1);
+		for( int i = 0; i < n_in && is_chain; i++ ) {
+			int l_in = _in_links[_in_first[v] + i];
+			for( int k = _out_first[v]; k < _out_first[v + 1]; k++ ) {
+				int l_out = _out_links[k];
+				if( _link_end[l_out] == _link_start[l_in] ) continue;
+				if( next[i] != -1 ) is_chain = false;
+				next[i] = l_out;
+			}
+			if( next[i] == -1 ) is_chain = false;
+		}
+		if( n_in == 2 && next[0] == next[1] ) is_chain = false;
+		if( is_chain == false ) continue;
+
+		chain_node[v] = true;
+		for( int i = 0; i < n_in; i++ ) next_in_chain[_in_links[_in_first[v] + i]] = next[i];
+
+	}
+
+	// Building the super links, starting from every link leaving a non-chain node towards a chain node
+
+	vector<bool> removed_node(n_nodes, false);
+	unsigned int n_removed = 0;
+
+	for( int l = 0; l < n_links; l++ ) {
+
+		if( chain_node[_link_start[l]] == true || chain_node[_link_end[l]] == false ) continue;
+
+		vector<int> members(1, l);
+		while( chain_node[_link_end[members.back()]] == true && (int)members.size() <= n_links ) {
+			removed_node[_link_end[members.back()]] = true;
+			members.push_back(next_in_chain[members.back()]);
+		}
+
+		const Link& first = _Links.at(_link_ids[members.front()]);
+		const Link& last  = _Links.at(_link_ids[members.back()]);
+
+		float length   = 0.0f;
+		float ff_time  = 0.0f;
+		float capacity = std::numeric_limits<float>::max();
+		vector<std::string> members_id;
+		for( int m : members ) {
+			const Link& lnk = _Links.at(_link_ids[m]);
+			length  += lnk.getLength();
+			ff_time += lnk.getFreeFlowTime();
+			capacity = min(capacity, lnk.getCapacity());
+			members_id.push_back(lnk.getId());
+		}
+
+		std::string id = "chain_" + first.getId();
+		Link super_link(id, first.getStartNodeId(), last.getEndNodeId(), length);
+		super_link.setFreeFlowTime(ff_time);
+		super_link.setCapacity(capacity * members.size());
+		super_link.setX(first.getX());
+		super_link.setY(first.getY());
+
+		// ... the super link replaces the first link among the outgoing links of its source node
+		Node& source = _Nodes.at(first.getStartNodeId());
+		vector<std::string> links_out = source.getLinksOutId();
+		replace(links_out.begin(), links_out.end(), first.getId(), id);
+		source.setLinksOutId(links_out);
+
+		_chains[id] = members_id;
+		for( const auto& m : members_id ) {
+			_chain_of[m]    = id;
+			_chain_links[m] = _Links.at(m);
+			_Links.erase(m);
+		}
+		_Links.insert(make_pair(id, super_link));
+
+	}
+
+	for( int v = 0; v < n_nodes; v++ ) {
+		if( removed_node[v] == true ) {
+			_Nodes.erase(_node_ids[v]);
+			n_removed++;
+		}
+	}
+
+	return n_removed;
+
+}
+
+
+vector<std::string> Network::getOriginalLinks(const std::string& linkId) const {
+
+	auto it = _chains.find(linkId);
+	if( it == _chains.end() ) return vector<std::string>(1, linkId);
+
+	return it->second;
+
+}
+
+
+bool Network::contractPath(const vector<std::string>& path, vector<std::string>& contracted) const {
+
+	contracted.clear();
+
+	// Travelling the path from its first link, every chain being matched link by link
+	for( int p = (int)path.size() - 1; p >= 0; p-- ) {
+
+		auto it = _chain_of.find(path[p]);
+		if( it == _chain_of.end() ) {
+			contracted.push_back(path[p]);
+			continue;
+		}
+
+		const vector<std::string>& members = _chains.at(it->second);
+		if( p + 1 < (int)members.size() ) return false;
+		for( unsigned int m = 0; m < members.size(); m++ ) {
+			if( path[p - m] != members[m] ) return false;
+		}
+
+		contracted.push_back(it->second);
+		p -= (int)members.size() - 1;
+
+	}
+
+	reverse(contracted.begin(), contracted.end());
+
+	return true;
+
+}
+
+
+const Link& Network::getOriginalLink(const std::string& linkId) const {
+
+	auto it = _chain_links.find(linkId);
+	if( it != _chain_links.end() ) return it->second;
+
+	return _Links.at(linkId);
+
+}
+
+
+std::string Network::changeLink(const std::string& linkId, float capacity, float freeFlowTime) {
+
+	auto it = _chain_of.find(linkId);
+	if( it == _chain_of.end() ) {
+		_Links.at(linkId).setCapacity(capacity);
+		_Links.at(linkId).setFreeFlowTime(freeFlowTime);
+		return linkId;
+	}
+
+	_chain_links.at(linkId).setCapacity(capacity);
+	_chain_links.at(linkId).setFreeFlowTime(freeFlowTime);
+
+	// ... the super link sums the free flow times and faces the bottleneck of its links
+	const vector<std::string>& members = _chains.at(it->second);
+	float ff_time      = 0.0f;
+	float min_capacity = std::numeric_limits<float>::max();
+	for( const auto& m : members ) {
+		ff_time     += _chain_links.at(m).getFreeFlowTime();
+		min_capacity = min(min_capacity, _chain_links.at(m).getCapacity());
+	}
+	Link& super_link = _Links.at(it->second);
+	super_link.setFreeFlowTime(ff_time);
+	super_link.setCapacity(min_capacity * members.size());
+
+	return it->second;
+
+}
+
+
+std::string Network::getOriginalLinkAt(const std::string& linkId, float progress, float& link_progress) const {
+
+	link_progress = progress;
+	auto it = _chains.find(linkId);
+	if( it == _chains.end() ) return linkId;
+
+	float target  = progress * _Links.at(linkId).getFreeFlowTime();
+	float ff_time = 0.0f;
+	for( const auto& m : it->second ) {
+		float ff_time_link = _chain_links.at(m).getFreeFlowTime();
+		if( target < ff_time + ff_time_link ) {
+			link_progress = ff_time_link > 0.0f ? ( target - ff_time ) / ff_time_link : 1.0f;
+			return m;
+		}
+		ff_time += ff_time_link;
+	}
+
+	link_progress = 1.0f;
+	return it->second.back();
+
+}
+
+
 float Network::euclidian_distance(std::string source_id, std::string dest_id) {
 
 	/*
@@ -240,19 +1198,24 @@ void Network::shuffleNodesCoordinates() {
   //int n_nodes = _Nodes.size();
   int cur_node = 0;
   int n_proc = RepastProcess::instance()->worldSize();
-  
+
+  // saving original data
   for( auto& n : _Nodes ) {
-    
-    // saving original data
     n.second.setXData(n.second.getX());
     n.second.setYData(n.second.getY());
+  }
+
+  for( auto& n : _Nodes ) {
 
     // computing the new coordinates
     
     //double x = this->min_x + rnd.doub() * (this->max_x - this->min_x);
     //double y = this->min_y + rnd.doub() * (this->max_x - this->min_y);
 
-    int node_proc = cur_node % n_proc;
+    // ... a sharded network being divided along the Hilbert curve (see setPartition)
+    int node_proc;
+    if( _partition >= 0 ) node_proc = getNodeOwner(n.first);
+    else                  node_proc = cur_node % n_proc;
 
     double x = node_proc + 0.5;
     double y = 0.5;
@@ -273,6 +1236,42 @@ void Network::shuffleNodesCoordinates() {
   
 }
 
+
+void Network::setPartition(int rank, double min_x, double max_x, double min_y, double max_y, const vector<unsigned long>& first_keys) {
+
+	_partition       = rank;
+	_curve_min_x     = min_x;
+	_curve_min_y     = min_y;
+	_curve_scale     = hilbertScale(min_x, max_x, min_y, max_y);
+	_owner_first_key = first_keys;
+
+}
+
+
+int Network::getOwnerAt(double x, double y) const {
+
+	if( _owner_first_key.empty() == true ) return -1;
+
+	// ... the last process whose range starts at or before the key
+	unsigned long key = getCurveKey(x, y);
+	int owner = (int)( upper_bound(_owner_first_key.begin() + 1, _owner_first_key.end(), key) - _owner_first_key.begin() ) - 1;
+
+	return owner;
+
+}
+
+
+int Network::getNodeOwner(const std::string& nodeId) const {
+
+	auto it = _Nodes.find(nodeId);
+	if( it == _Nodes.end() ) return -1;
+
+	if( _partition < 0 ) return (int)it->second.getX();
+
+	return getOwnerAt(it->second.getXData(), it->second.getYData());
+
+}
+
 // Constructor
 Node::Node(std::string id, double x, double y) :
   _id(id), _x(x), _y(y), _indicators(), _x_data(x), _y_data(y) {
@@ -303,7 +1302,12 @@ Link::Link(std::string id, std::string start_node, std::string end_node, float l
 
 // Time required to go through the link
 float Link::timeOnLink() const {
-	return  _free_flow_time * ( 1.0f + 0.15f * boost::math::pow<4,float>( (float)( _n_agents / _capacity ) ) );
+	return timeOnLink(_n_agents);
+}
+
+// Time required to go through the link with a given number of agents on it
+float Link::timeOnLink(unsigned int n_agents) const {
+	return  _free_flow_time * ( 1.0f + 0.15f * boost::math::pow<4,float>( (float)( n_agents / _capacity ) ) );
 }
 
 
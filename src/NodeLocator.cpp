@@ -0,0 +1,140 @@
+/****************************************************************
+ * NODELOCATOR.CPP
+ *
+ * This file contains all the definitions of the methods of
+ * NodeLocator.hpp (see this file for methods' documentation)
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+#include "../include/NodeLocator.hpp"
+
+using namespace std;
+
+
+void NodeLocator::build(const Network& network) {
+
+	_ids.clear();
+	_x.clear();
+	_y.clear();
+	_link_end.clear();
+
+	for( const auto& n : network.getNodes() ) addNode(n.first, n.second.getXData(), n.second.getYData());
+	for( const auto& lnk : network.getLinks() ) addLink(lnk.first, lnk.second.getEndNodeId());
+
+	index();
+
+}
+
+
+void NodeLocator::addNode(const std::string& id, double x, double y) {
+
+	_ids.push_back(id);
+	_x.push_back(x);
+	_y.push_back(y);
+
+}
+
+
+void NodeLocator::index() {
+
+	double max_x = -std::numeric_limits<double>::max();
+	double max_y = -std::numeric_limits<double>::max();
+	_min_x = std::numeric_limits<double>::max();
+	_min_y = std::numeric_limits<double>::max();
+	for( unsigned int n = 0; n < _ids.size(); n++ ) {
+		_min_x = min(_min_x, _x[n]);
+		_min_y = min(_min_y, _y[n]);
+		max_x  = max(max_x, _x[n]);
+		max_y  = max(max_y, _y[n]);
+	}
+
+	int n_nodes = (int)_ids.size();
+	if( n_nodes == 0 ) {
+		_n_cols = 0;
+		_n_rows = 0;
+		return;
+	}
+
+	// About two nodes per cell
+	double width  = max(max_x - _min_x, 1e-9);
+	double height = max(max_y - _min_y, 1e-9);
+	_cell_size = max(sqrt(width * height / max(n_nodes / 2, 1)), 1e-9);
+	_n_cols    = (int)( width  / _cell_size ) + 1;
+	_n_rows    = (int)( height / _cell_size ) + 1;
+
+	// Packed grid
+	vector<int> cell(n_nodes);
+	_cell_first.assign((long)_n_cols * _n_rows + 1, 0);
+	for( int n = 0; n < n_nodes; n++ ) {
+		cell[n] = cellOf(_y[n], _min_y, _n_rows) * _n_cols + cellOf(_x[n], _min_x, _n_cols);
+		_cell_first[cell[n] + 1]++;
+	}
+	for( unsigned int c = 1; c < _cell_first.size(); c++ ) _cell_first[c] += _cell_first[c - 1];
+
+	_cell_nodes.assign(n_nodes, 0);
+	vector<int> pos(_cell_first.begin(), _cell_first.end() - 1);
+	for( int n = 0; n < n_nodes; n++ ) _cell_nodes[pos[cell[n]]++] = n;
+
+}
+
+
+int NodeLocator::cellOf(double coord, double min_coord, int n_cells) const {
+
+	int c = (int)floor( ( coord - min_coord ) / _cell_size );
+
+	return max(0, min(c, n_cells - 1));
+
+}
+
+
+std::string NodeLocator::nearestNode(double x, double y) const {
+
+	if( _ids.empty() == true ) return "";
+
+	int cx = cellOf(x, _min_x, _n_cols);
+	int cy = cellOf(y, _min_y, _n_rows);
+
+	int    best      = -1;
+	double best_dist = std::numeric_limits<double>::max();
+	int    max_ring  = max(_n_cols, _n_rows);
+
+	for( int r = 0; r <= max_ring; r++ ) {
+
+		// ... every cell at Chebyshev distance r of the location cell
+		for( int j = cy - r; j <= cy + r; j++ ) {
+			if( j < 0 || j >= _n_rows ) continue;
+			int step = ( j == cy - r || j == cy + r ) ? 1 : 2 * r;
+			for( int i = cx - r; i <= cx + r; i += max(step, 1) ) {
+				if( i < 0 || i >= _n_cols ) continue;
+				int c = j * _n_cols + i;
+				for( int k = _cell_first[c]; k < _cell_first[c + 1]; k++ ) {
+					int n = _cell_nodes[k];
+					double d = ( _x[n] - x ) * ( _x[n] - x ) + ( _y[n] - y ) * ( _y[n] - y );
+					if( d < best_dist || ( d == best_dist && _ids[n] < _ids[best] ) ) {
+						best      = n;
+						best_dist = d;
+					}
+				}
+			}
+		}
+
+		// ... nodes beyond ring r are at least r cells away (also for a location outside the grid)
+		double bound = r * _cell_size;
+		if( best >= 0 && best_dist <= bound * bound ) break;
+
+	}
+
+	return _ids[best];
+
+}
+
+
+std::string NodeLocator::linkEndNode(const std::string& linkId) const {
+
+	auto it = _link_end.find(linkId);
+	if( it == _link_end.end() ) return "";
+
+	return it->second;
+
+}
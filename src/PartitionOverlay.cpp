@@ -0,0 +1,375 @@
+/****************************************************************
+ * PARTITIONOVERLAY.CPP
+ *
+ * This file contains all the definitions of the methods of
+ * PartitionOverlay.hpp (see this file for methods' documentation)
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+#include "../include/PartitionOverlay.hpp"
+
+using namespace std;
+
+
+void PartitionOverlay::build(const Network& network, boost::mpi::communicator& comm) {
+
+	int rank = network.getPartition();
+
+	// Local links at free flow, the links leaving the partition being excluded
+	_local_cost = network.getLinksTime();
+	for( int l = 0; l < network.getNLinksIndexed(); l++ ) {
+		if( network.isInPartition(network.getNodeIdByIndex(network.getLinkEndIndex(l))) == false ) {
+			_local_cost[l] = std::numeric_limits<float>::max();
+		}
+	}
+
+	// Boundary nodes of the local partition...
+	set<std::string> boundary;
+	for( const auto& lnk : network.getLinks() ) {
+		bool start_in = network.isInPartition(lnk.second.getStartNodeId());
+		bool end_in   = network.isInPartition(lnk.second.getEndNodeId());
+		if( start_in == true  && end_in == false ) boundary.insert(lnk.second.getStartNodeId());
+		if( start_in == false && end_in == true )  boundary.insert(lnk.second.getEndNodeId());
+	}
+
+	// ... and of every partition, numbered by process then by id
+	vector<vector<std::string>> boundary_gather;
+	boost::mpi::all_gather(comm, vector<std::string>(boundary.begin(), boundary.end()), boundary_gather);
+
+	_vertex_ids.clear();
+	_vertex_index.clear();
+	_local_vertices.clear();
+	for( int p = 0; p < (int)boundary_gather.size(); p++ ) {
+		for( const auto& id : boundary_gather[p] ) {
+			if( p == rank ) _local_vertices.push_back((int)_vertex_ids.size());
+			_vertex_index[id] = (int)_vertex_ids.size();
+			_vertex_ids.push_back(id);
+		}
+	}
+
+	// Edges of the local partition: shortcuts between its boundary nodes...
+	vector<int>         from, to;
+	vector<float>       cost;
+	computeShortcuts(network, from, to, cost);
+	vector<std::string> link(from.size(), "");
+
+	// ... and the links leaving it
+	for( const auto& lnk : network.getLinks() ) {
+		if( network.isInPartition(lnk.second.getStartNodeId()) == true && network.isInPartition(lnk.second.getEndNodeId()) == false ) {
+			from.push_back(_vertex_index.at(lnk.second.getStartNodeId()));
+			to.push_back(_vertex_index.at(lnk.second.getEndNodeId()));
+			cost.push_back(lnk.second.getFreeFlowTime());
+			link.push_back(lnk.first);
+		}
+	}
+
+	// Gathering the edges of every partition, grouped by tail vertex
+
+	vector<vector<int>>         from_gather, to_gather;
+	vector<vector<float>>       cost_gather;
+	vector<vector<std::string>> link_gather;
+	boost::mpi::all_gather(comm, from, from_gather);
+	boost::mpi::all_gather(comm, to, to_gather);
+	boost::mpi::all_gather(comm, cost, cost_gather);
+	boost::mpi::all_gather(comm, link, link_gather);
+
+	int n_vertices = (int)_vertex_ids.size();
+	int n_edges    = 0;
+	_edge_first.assign(n_vertices + 1, 0);
+	for( const auto& f : from_gather ) {
+		for( int v : f ) _edge_first[v + 1]++;
+		n_edges += (int)f.size();
+	}
+	for( int v = 0; v < n_vertices; v++ ) _edge_first[v + 1] += _edge_first[v];
+
+	_edge_from.assign(n_edges, 0);
+	_edge_to.assign(n_edges, 0);
+	_edge_cost.assign(n_edges, 0.0f);
+	_edge_link.assign(n_edges, "");
+	vector<int> pos(_edge_first.begin(), _edge_first.end() - 1);
+	for( unsigned int p = 0; p < from_gather.size(); p++ ) {
+		for( unsigned int e = 0; e < from_gather[p].size(); e++ ) {
+			int k = pos[from_gather[p][e]]++;
+			_edge_from[k] = from_gather[p][e];
+			_edge_to[k]   = to_gather[p][e];
+			_edge_cost[k] = cost_gather[p][e];
+			_edge_link[k] = link_gather[p][e];
+		}
+	}
+
+}
+
+
+void PartitionOverlay::completeDestinations(const Network& network, const set<std::string>& destinations,
+		                                    boost::mpi::communicator& comm) {
+
+	// Destinations not requested yet by every process
+	vector<std::string> request;
+	for( const auto& d : destinations ) if( _completion_owner.count(d) == 0 ) request.push_back(d);
+
+	vector<vector<std::string>> request_gather;
+	boost::mpi::all_gather(comm, request, request_gather);
+
+	bool any_request = false;
+	for( const auto& r : request_gather ) any_request = any_request || r.empty() == false;
+	if( any_request == false ) return;
+
+	// Distances from the local boundary nodes to the local destinations requested, sent to the requesting processes
+	vector<vector<int>>   slot_send(request_gather.size()), vertex_send(request_gather.size());
+	vector<vector<float>> dist_send(request_gather.size());
+	for( unsigned int p = 0; p < request_gather.size(); p++ ) {
+		computeCompletion(network, request_gather[p], slot_send[p], vertex_send[p], dist_send[p]);
+	}
+
+	vector<vector<int>>   slot_recv, vertex_recv;
+	vector<vector<float>> dist_recv;
+	boost::mpi::all_to_all(comm, slot_send, slot_recv);
+	boost::mpi::all_to_all(comm, vertex_send, vertex_recv);
+	boost::mpi::all_to_all(comm, dist_send, dist_recv);
+
+	// ... the destinations owned by no process not being requested again
+	for( const auto& d : request ) _completion_owner[d] = -1;
+	for( unsigned int p = 0; p < slot_recv.size(); p++ ) {
+		for( unsigned int e = 0; e < slot_recv[p].size(); e++ ) {
+			const std::string& d = request[slot_recv[p][e]];
+			_completion_owner[d] = (int)p;
+			if( vertex_recv[p][e] >= 0 ) _completion[d].push_back(make_pair(vertex_recv[p][e], dist_recv[p][e]));
+		}
+	}
+
+}
+
+
+void PartitionOverlay::computeShortcuts(const Network& network, vector<int>& from, vector<int>& to, vector<float>& cost) const {
+
+	vector<float> dist;
+	vector<int>   pred;
+	for( int a : _local_vertices ) {
+		network.computeTree(network.getNodeIndex(_vertex_ids[a]), _local_cost, dist, pred);
+		for( int b : _local_vertices ) {
+			float d = dist[network.getNodeIndex(_vertex_ids[b])];
+			if( a != b && d < std::numeric_limits<float>::max() ) {
+				from.push_back(a);
+				to.push_back(b);
+				cost.push_back(d);
+			}
+		}
+	}
+
+}
+
+
+void PartitionOverlay::computeCompletion(const Network& network, const vector<std::string>& dest_ids,
+		                                 vector<int>& slot, vector<int>& vertex, vector<float>& dist_dest) const {
+
+	vector<int>   next_link;
+	vector<float> dist;
+	for( unsigned int s = 0; s < dest_ids.size(); s++ ) {
+
+		if( network.getNodeOwner(dest_ids[s]) != network.getPartition() ) continue;
+
+		// ... the owner being known even without any boundary node leading to the destination
+		slot.push_back((int)s);
+		vertex.push_back(-1);
+		dist_dest.push_back(0.0f);
+
+		network.computeTreeToDestination(network.getNodeIndex(dest_ids[s]), _local_cost, next_link, dist);
+		for( int b : _local_vertices ) {
+			float d = dist[network.getNodeIndex(_vertex_ids[b])];
+			if( d < std::numeric_limits<float>::max() ) {
+				slot.push_back((int)s);
+				vertex.push_back(b);
+				dist_dest.push_back(d);
+			}
+		}
+
+	}
+
+}
+
+
+unsigned int PartitionOverlay::updateLinks(const Network& network, const vector<int>& links, boost::mpi::communicator& comm) {
+
+	// Changed links of the local partition: links inside it and links leaving it
+	bool                inner_changed = false;
+	vector<std::string> leaving_link;
+	vector<int>         leaving_from;
+	vector<float>       leaving_cost;
+	for( int l : links ) {
+		bool start_in = network.isInPartition(network.getNodeIdByIndex(network.getLinkStartIndex(l)));
+		bool end_in   = network.isInPartition(network.getNodeIdByIndex(network.getLinkEndIndex(l)));
+		float ff_time = network.getLinks().at(network.getLinkIdByIndex(l)).getFreeFlowTime();
+		if( end_in == true ) {
+			_local_cost[l] = ff_time;
+			if( start_in == true ) inner_changed = true;
+		}
+		else if( start_in == true ) {
+			leaving_link.push_back(network.getLinkIdByIndex(l));
+			leaving_from.push_back(_vertex_index.at(network.getNodeIdByIndex(network.getLinkStartIndex(l))));
+			leaving_cost.push_back(ff_time);
+		}
+	}
+
+	// ... the shortcuts of the partition only recomputed if a link inside it changed
+	vector<int>   from, to;
+	vector<float> cost;
+	if( inner_changed == true ) computeShortcuts(network, from, to, cost);
+
+	vector<int>                 changed_gather;
+	vector<vector<std::string>> leaving_link_gather;
+	vector<vector<float>>       leaving_cost_gather, cost_gather;
+	vector<vector<int>>         leaving_from_gather, from_gather, to_gather;
+	boost::mpi::all_gather(comm, (int)inner_changed, changed_gather);
+	boost::mpi::all_gather(comm, leaving_link, leaving_link_gather);
+	boost::mpi::all_gather(comm, leaving_from, leaving_from_gather);
+	boost::mpi::all_gather(comm, leaving_cost, leaving_cost_gather);
+	boost::mpi::all_gather(comm, from, from_gather);
+	boost::mpi::all_gather(comm, to, to_gather);
+	boost::mpi::all_gather(comm, cost, cost_gather);
+
+	// Updating the edges (costs being positive, the shortcuts joining the same vertices)
+	unsigned int n_partitions = 0;
+	set<std::string> outdated;
+	for( unsigned int p = 0; p < changed_gather.size(); p++ ) {
+
+		for( unsigned int k = 0; k < leaving_link_gather[p].size(); k++ ) {
+			int a = leaving_from_gather[p][k];
+			for( int e = _edge_first[a]; e < _edge_first[a + 1]; e++ ) {
+				if( _edge_link[e] == leaving_link_gather[p][k] ) _edge_cost[e] = leaving_cost_gather[p][k];
+			}
+		}
+
+		if( changed_gather[p] == 0 ) continue;
+		n_partitions++;
+
+		for( unsigned int k = 0; k < from_gather[p].size(); k++ ) {
+			int a = from_gather[p][k];
+			for( int e = _edge_first[a]; e < _edge_first[a + 1]; e++ ) {
+				if( _edge_to[e] == to_gather[p][k] && _edge_link[e].empty() == true ) _edge_cost[e] = cost_gather[p][k];
+			}
+		}
+
+		for( const auto& d : _completion_owner ) if( d.second == (int)p ) outdated.insert(d.first);
+
+	}
+
+	// The completions owned by the partitions changed being requested again
+	for( const auto& d : outdated ) {
+		_completion.erase(d);
+		_completion_owner.erase(d);
+	}
+	completeDestinations(network, outdated, comm);
+
+	return n_partitions;
+
+}
+
+
+vector<std::string> PartitionOverlay::computePath(const Network& network, const std::string& source_id,
+		                                          const std::string& dest_id, const std::string& link_id_to_avoid) const {
+
+	vector<std::string> result;
+	if( source_id == dest_id ) return result;
+
+	// Local search ------------------------------------------------------
+
+	vector<float> cost = _local_cost;
+	if( link_id_to_avoid.empty() == false ) {
+		int l = network.getLinkIndex(link_id_to_avoid);
+		cost[l] = max(cost[l], std::numeric_limits<float>::max() * 0.5f);
+	}
+
+	int source = network.getNodeIndex(source_id);
+	vector<float> dist;
+	vector<int>   pred;
+	network.computeTree(source, cost, dist, pred);
+
+	// ... direct path if the destination is in the partition
+	float best   = std::numeric_limits<float>::max();
+	int   target = -1;                                                   // last local node of the path
+	if( network.getNodeOwner(dest_id) == network.getPartition() ) {
+		target = network.getNodeIndex(dest_id);
+		best   = dist[target];
+	}
+
+	// Overlay search, from the local boundary nodes to the completed destination
+
+	int best_vertex = -1;
+	vector<int> pred_edge;
+	auto it_comp = _completion.find(dest_id);
+	if( it_comp != _completion.end() ) {
+
+		int n_vertices = (int)_vertex_ids.size();
+		vector<float> comp(n_vertices, std::numeric_limits<float>::max());
+		for( const auto& c : it_comp->second ) comp[c.first] = c.second;
+
+		FibonacciHeap<int,float> Q;                                      // Fibonacci heap of the tentative vertices
+		vector<FibonacciHeapNode<int,float>*> Q_nodes(n_vertices, NULL); // pointers to the nodes of the F-heap
+		vector<float> D(n_vertices, std::numeric_limits<float>::max());  // distance from the source
+		vector<bool>  closed(n_vertices, false);                         // vertices already settled
+		pred_edge.assign(n_vertices, -1);
+
+		for( int v : _local_vertices ) {
+			float d = dist[network.getNodeIndex(_vertex_ids[v])];
+			if( d < std::numeric_limits<float>::max() ) {
+				D[v] = d;
+				Q_nodes[v] = Q.insert(v, d);
+			}
+		}
+
+		while( Q.empty() == false ) {
+
+			int   u = Q.minimum()->data();
+			float d = Q.minimum()->key();
+			Q.deletemin();
+			closed[u] = true;
+
+			if( d >= best ) break;
+
+			// ... completion to the destination
+			if( comp[u] < std::numeric_limits<float>::max() && d + comp[u] < best ) {
+				best        = d + comp[u];
+				best_vertex = u;
+			}
+
+			for( int e = _edge_first[u]; e < _edge_first[u + 1]; e++ ) {
+				int v = _edge_to[e];
+				if( closed[v] == true || ( _edge_link[e].empty() == false && _edge_link[e] == link_id_to_avoid ) ) continue;
+				float w = d + _edge_cost[e];
+				if( w < D[v] ) {
+					D[v] = w;
+					pred_edge[v] = e;
+					if( Q_nodes[v] == NULL ) Q_nodes[v] = Q.insert(v, w);
+					else                     Q.decreaseKey(Q_nodes[v], w);
+				}
+			}
+
+		}
+
+	}
+
+	if( best == std::numeric_limits<float>::max() ) return result;
+
+	// The path leaves the partition through the first link of the overlay path joining two partitions
+	if( best_vertex >= 0 ) {
+		int exit_edge = -1;
+		for( int v = best_vertex; pred_edge[v] >= 0; v = _edge_from[pred_edge[v]] ) {
+			if( _edge_link[pred_edge[v]].empty() == false ) exit_edge = pred_edge[v];
+		}
+		if( exit_edge >= 0 ) {
+			result.push_back(_edge_link[exit_edge]);
+			target = network.getNodeIndex(_vertex_ids[_edge_from[exit_edge]]);
+		}
+	}
+
+	if( target < 0 || dist[target] == std::numeric_limits<float>::max() ) return vector<std::string>();
+
+	// Reconstructing the local part of the path
+	for( int cur = target; cur != source; cur = network.getLinkStartIndex(pred[cur]) ) {
+		result.push_back(network.getLinkIdByIndex(pred[cur]));
+	}
+
+	return result;
+
+}
@@ -0,0 +1,71 @@
+/****************************************************************
+ * PERFCOUNTER.CPP
+ *
+ * This file contains all the definitions of the methods of
+ * PerfCounter.hpp (see this file for methods' documentation)
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+#include "../include/PerfCounter.hpp"
+
+#ifdef __linux__
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+
+PerfCounter::~PerfCounter() {
+
+#ifdef __linux__
+	if( _fd >= 0 ) close(_fd);
+#endif
+
+}
+
+
+bool PerfCounter::open() {
+
+#ifdef __linux__
+	perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size           = sizeof(attr);
+	attr.type           = PERF_TYPE_HARDWARE;
+	attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled       = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv     = 1;
+
+	// ... calling thread, on any CPU
+	_fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+
+	return _fd >= 0;
+
+}
+
+
+void PerfCounter::start() {
+
+#ifdef __linux__
+	if( _fd < 0 ) return;
+	ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+	ioctl(_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+
+}
+
+
+void PerfCounter::stop() {
+
+#ifdef __linux__
+	if( _fd < 0 ) return;
+	ioctl(_fd, PERF_EVENT_IOC_DISABLE, 0);
+	long long count = 0;
+	if( read(_fd, &count, sizeof(count)) == sizeof(count) ) _total += count;
+#endif
+
+}
@@ -0,0 +1,180 @@
+/****************************************************************
+ * PLACEMENT.CPP
+ *
+ * This file contains all the definitions of the methods of
+ * Placement.hpp (see this file for methods' documentation)
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+#include <map>
+#include <sstream>
+#include "../include/Placement.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace std;
+
+#ifndef MPOL_INTERLEAVE
+#define MPOL_INTERLEAVE 3                                                // (linux/mempolicy.h)
+#endif
+
+bool Placement::_huge_pages = false;
+
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+
+void* Placement::allocate(size_t bytes) {
+
+	if( bytes == 0 ) bytes = 1;
+
+#ifdef __linux__
+	if( _huge_pages == true && bytes >= HUGE_PAGE_SIZE ) {
+		void* p = NULL;
+		size_t rounded = ( bytes + HUGE_PAGE_SIZE - 1 ) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+		if( posix_memalign(&p, HUGE_PAGE_SIZE, rounded) != 0 ) return NULL;
+		madvise(p, rounded, MADV_HUGEPAGE);
+		return p;
+	}
+#endif
+
+	return malloc(bytes);
+
+}
+
+
+bool Placement::pinThreads() {
+
+#ifdef __linux__
+	// Cores given to the process (by the MPI launcher binding), shared in order among the threads
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if( sched_getaffinity(0, sizeof(allowed), &allowed) != 0 ) return false;
+
+	vector<int> cores;
+	for( int c = 0; c < CPU_SETSIZE; c++ ) {
+		if( CPU_ISSET(c, &allowed) ) cores.push_back(c);
+	}
+	if( cores.empty() == true ) return false;
+
+	bool pinned = true;
+#pragma omp parallel reduction(&&:pinned)
+	{
+		int t = 0;
+#ifdef _OPENMP
+		t = omp_get_thread_num();
+#endif
+		cpu_set_t core;
+		CPU_ZERO(&core);
+		CPU_SET(cores[t % cores.size()], &core);
+		pinned = sched_setaffinity(0, sizeof(core), &core) == 0;
+	}
+
+	return pinned;
+#else
+	return false;
+#endif
+
+}
+
+
+string Placement::describeThreads() {
+
+	int n_threads = 1;
+#ifdef _OPENMP
+	n_threads = omp_get_max_threads();
+#endif
+	vector<int> cpus(n_threads, -1), nodes(n_threads, -1);
+
+#pragma omp parallel
+	{
+		int t = 0;
+#ifdef _OPENMP
+		t = omp_get_thread_num();
+#endif
+#ifdef __linux__
+		unsigned int cpu = 0, node = 0;
+		if( syscall(SYS_getcpu, &cpu, &node, NULL) == 0 ) {
+			cpus[t]  = (int)cpu;
+			nodes[t] = (int)node;
+		}
+#endif
+	}
+
+	ostringstream result;
+	for( int t = 0; t < n_threads; t++ ) {
+		if( t > 0 ) result << " ";
+		result << t << ":cpu" << cpus[t] << "/node" << nodes[t];
+	}
+
+	return result.str();
+
+}
+
+
+bool Placement::interleavePages(void* data, size_t bytes) {
+
+#if defined(__linux__) && defined(SYS_mbind)
+	long page_size = sysconf(_SC_PAGESIZE);
+	if( data == NULL || page_size <= 0 ) return false;
+
+	// Nodes of the threads
+	unsigned long mask = 0;
+#pragma omp parallel reduction(|:mask)
+	{
+		unsigned int cpu = 0, node = 0;
+		if( syscall(SYS_getcpu, &cpu, &node, NULL) == 0 && node < 8 * sizeof(mask) ) mask |= 1ul << node;
+	}
+	if( mask == 0 ) return false;
+
+	// ... the policy being set on the whole pages of the block only
+	unsigned long first = ( (unsigned long)data + page_size - 1 ) / page_size * page_size;
+	unsigned long last  = ( (unsigned long)data + bytes ) / page_size * page_size;
+	if( last <= first ) return true;
+
+	return syscall(SYS_mbind, (void*)first, last - first, MPOL_INTERLEAVE, &mask, 8 * sizeof(mask) + 1, 0) == 0;
+#else
+	return false;
+#endif
+
+}
+
+
+string Placement::describePages(const void* data, size_t bytes) {
+
+	ostringstream result;
+
+#if defined(__linux__) && defined(SYS_move_pages)
+	long page_size = sysconf(_SC_PAGESIZE);
+	if( data == NULL || bytes == 0 || page_size <= 0 ) return "";
+
+	// ... node of every page (move_pages without target nodes only queries them)
+	unsigned long first = (unsigned long)data / page_size * page_size;
+	unsigned long n     = ( (unsigned long)data + bytes - first + page_size - 1 ) / page_size;
+	vector<void*> pages(n);
+	vector<int>   status(n, -1);
+	for( unsigned long p = 0; p < n; p++ ) pages[p] = (void*)( first + p * page_size );
+	if( syscall(SYS_move_pages, 0, n, pages.data(), NULL, status.data(), 0) != 0 ) return "";
+
+	map<int, unsigned long> n_pages;
+	for( int s : status ) {
+		if( s >= 0 ) n_pages[s]++;
+	}
+	for( auto it = n_pages.begin(); it != n_pages.end(); it++ ) {
+		if( it != n_pages.begin() ) result << ", ";
+		result << "node" << it->first << " " << it->second;
+	}
+#endif
+
+	return result.str();
+
+}
@@ -0,0 +1,110 @@
+/****************************************************************
+ * POSITIONSWRITER.CPP
+ *
+ * This file contains all the definitions of the methods of
+ * PositionsWriter.hpp (see this file for methods' documentation)
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+#include <cstring>
+#include "../include/PositionsWriter.hpp"
+
+using namespace std;
+
+static_assert(sizeof(PositionRecord) == 12, "position records must be 12 bytes long");
+
+
+PositionsWriter::~PositionsWriter() {
+
+	close();
+
+}
+
+
+bool PositionsWriter::open(const std::string& basename) {
+
+	_file_frames = fopen( (basename + ".bin").c_str(), "wb" );
+	_file_index  = fopen( (basename + ".idx").c_str(), "wb" );
+	if( _file_frames == NULL || _file_index == NULL ) {
+		if( _file_frames != NULL ) fclose(_file_frames);
+		if( _file_index != NULL )  fclose(_file_index);
+		_file_frames = NULL;
+		_file_index  = NULL;
+		return false;
+	}
+
+	fwrite("TSPOS001", 1, 8, _file_frames);
+	_offset  = 8;
+	_closing = false;
+	_thread  = std::thread(&PositionsWriter::run, this);
+
+	return true;
+
+}
+
+
+void PositionsWriter::addFrame(float time, const std::vector<PositionRecord>& records) {
+
+	if( isOpen() == false ) return;
+
+	// frame header (time, number of records) followed by the records
+	uint32_t n_records = (uint32_t)records.size();
+	vector<char> frame(8 + records.size() * sizeof(PositionRecord));
+	memcpy(frame.data(), &time, 4);
+	memcpy(frame.data() + 4, &n_records, 4);
+	if( records.empty() == false ) memcpy(frame.data() + 8, records.data(), records.size() * sizeof(PositionRecord));
+
+	{
+		lock_guard<mutex> lock(_mutex);
+		_queue.push_back(std::move(frame));
+	}
+	_cond.notify_one();
+
+}
+
+
+void PositionsWriter::run() {
+
+	while( true ) {
+
+		vector<char> frame;
+		{
+			unique_lock<mutex> lock(_mutex);
+			_cond.wait(lock, [this]() { return _queue.empty() == false || _closing == true; });
+			if( _queue.empty() == true ) return;
+			frame = std::move(_queue.front());
+			_queue.pop_front();
+		}
+
+		// index entry: time, number of records and offset of the frame
+		char entry[16];
+		memcpy(entry, frame.data(), 8);
+		memcpy(entry + 8, &_offset, 8);
+		fwrite(entry, 1, 16, _file_index);
+
+		fwrite(frame.data(), 1, frame.size(), _file_frames);
+		_offset += frame.size();
+
+	}
+
+}
+
+
+void PositionsWriter::close() {
+
+	if( isOpen() == false ) return;
+
+	{
+		lock_guard<mutex> lock(_mutex);
+		_closing = true;
+	}
+	_cond.notify_one();
+	_thread.join();
+
+	fclose(_file_frames);
+	fclose(_file_index);
+	_file_frames = NULL;
+	_file_index  = NULL;
+
+}
@@ -0,0 +1,231 @@
+/****************************************************************
+ * ROUTECACHE.CPP
+ *
+ * This file contains all the definitions of the methods of
+ * RouteCache.hpp (see this file for methods' documentation)
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+#include "../include/RouteCache.hpp"
+
+using namespace std;
+
+
+//! Send a message to every process and receive one from every process, only the non-empty ones being sent.
+static void sparseAllToAll(boost::mpi::communicator& comm, const vector<vector<int>>& out, vector<vector<int>>& in) {
+
+	vector<int> size_out(comm.size(), 0), size_in;
+	for( int p = 0; p < comm.size(); p++ ) size_out[p] = (int)out[p].size();
+	boost::mpi::all_to_all(comm, size_out, size_in);
+
+	in.assign(comm.size(), vector<int>());
+	vector<boost::mpi::request> requests;
+	for( int p = 0; p < comm.size(); p++ ) {
+		if( size_in[p] == 0 ) continue;
+		in[p].resize(size_in[p]);
+		requests.push_back(comm.irecv(p, 0, in[p].data(), size_in[p]));
+	}
+	for( int p = 0; p < comm.size(); p++ ) {
+		if( size_out[p] > 0 ) requests.push_back(comm.isend(p, 0, out[p].data(), size_out[p]));
+	}
+	boost::mpi::wait_all(requests.begin(), requests.end());
+
+}
+
+
+const vector<int>* PathStore::find(long key) {
+
+	auto it = _paths.find(key);
+	if( it == _paths.end() ) return NULL;
+
+	_order.splice(_order.begin(), _order, it->second.second);
+
+	return &it->second.first;
+
+}
+
+
+void PathStore::insert(long key, const vector<int>& path) {
+
+	if( _capacity == 0 ) return;
+
+	auto it = _paths.find(key);
+	if( it != _paths.end() ) {
+		it->second.first = path;
+		_order.splice(_order.begin(), _order, it->second.second);
+		return;
+	}
+
+	if( _paths.size() >= _capacity ) {
+		_paths.erase(_order.back());
+		_order.pop_back();
+	}
+
+	_order.push_front(key);
+	_paths.insert(make_pair(key, make_pair(path, _order.begin())));
+
+}
+
+
+unsigned int PathStore::eraseUsing(const set<int>& links) {
+
+	unsigned int n_erased = 0;
+
+	auto it = _paths.begin();
+	while( it != _paths.end() ) {
+		bool uses_link = false;
+		for( int l : it->second.first ) {
+			if( links.count(l) == 1 ) {
+				uses_link = true;
+				break;
+			}
+		}
+		if( uses_link == true ) {
+			_order.erase(it->second.second);
+			it = _paths.erase(it);
+			n_erased++;
+		}
+		else {
+			it++;
+		}
+	}
+
+	return n_erased;
+
+}
+
+
+int RouteCache::owner(long key, int n_proc) const {
+
+	// Fibonacci hashing, for the pairs of neighbouring nodes to be spread among the processes
+	unsigned long h = (unsigned long)key * 0x9E3779B97F4A7C15UL;
+
+	return (int)( ( h >> 32 ) % (unsigned long)n_proc );
+
+}
+
+
+void RouteCache::request(const Network& network, const std::string& origin_id, const std::string& dest_id,
+		                 int deliver_to, int n_proc) {
+
+	int  origin = network.getNodeIndex(origin_id);
+	int  dest   = network.getNodeIndex(dest_id);
+	long k      = key(network, origin, dest);
+
+	if( _requested.insert(k).second == false ) return;
+
+	_requests.resize(n_proc);
+	vector<int>& req = _requests[owner(k, n_proc)];
+	req.push_back(origin);
+	req.push_back(dest);
+	req.push_back(deliver_to);
+
+}
+
+
+bool RouteCache::find(const Network& network, const std::string& origin_id, const std::string& dest_id,
+		              vector<std::string>& path) {
+
+	const vector<int>* p = _near.find(key(network, network.getNodeIndex(origin_id), network.getNodeIndex(dest_id)));
+	if( p == NULL ) return false;
+
+	path.clear();
+	for( int l : *p ) path.push_back(network.getLinkIdByIndex(l));
+
+	return true;
+
+}
+
+
+bool RouteCache::contains(const Network& network, const std::string& origin_id, const std::string& dest_id) {
+
+	return _near.find(key(network, network.getNodeIndex(origin_id), network.getNodeIndex(dest_id))) != NULL;
+
+}
+
+
+void RouteCache::insert(const Network& network, const std::string& origin_id, const std::string& dest_id,
+		                const vector<std::string>& path) {
+
+	vector<int> p;
+	for( const auto& l : path ) p.push_back(network.getLinkIndex(l));
+
+	_near.insert(key(network, network.getNodeIndex(origin_id), network.getNodeIndex(dest_id)), p);
+
+}
+
+
+unsigned int RouteCache::exchange(Network& network, boost::mpi::communicator& comm, const vector<float>* cost,
+		                          std::map<std::pair<int, int>, std::vector<int>>* delivered) {
+
+	int n_proc = comm.size();
+
+	// Requests sent to the owners of their pair
+	_requests.resize(n_proc);
+	vector<vector<int>> received;
+	sparseAllToAll(comm, _requests, received);
+	_requests.assign(n_proc, vector<int>());
+	_requested.clear();
+
+	// Answers: origin, destination, path length and path links index, the paths not in the shard being computed once
+	vector<vector<int>> answers(n_proc);
+	unsigned int n_computed = 0;
+
+	for( const auto& req : received ) {
+		for( unsigned int i = 0; i + 2 < req.size(); i += 3 ) {
+
+			int  origin = req[i], dest = req[i + 1], deliver_to = req[i + 2];
+			long k      = key(network, origin, dest);
+
+			vector<int> computed;
+			const vector<int>* path = _shard.find(k);
+			if( path == NULL ) {
+				const std::string& origin_id = network.getNodeIdByIndex(origin);
+				const std::string& dest_id   = network.getNodeIdByIndex(dest);
+				for( const auto& l : cost == NULL ? network.computePathAStar(origin_id, dest_id) : network.computePath(origin_id, dest_id, *cost) ) {
+					computed.push_back(network.getLinkIndex(l));
+				}
+				_shard.insert(k, computed);
+				path = &computed;
+				n_computed++;
+				_n_misses++;
+			}
+			else {
+				_n_hits++;
+			}
+
+			vector<int>& ans = answers[deliver_to];
+			ans.push_back(origin);
+			ans.push_back(dest);
+			ans.push_back((int)path->size());
+			ans.insert(ans.end(), path->begin(), path->end());
+
+		}
+	}
+
+	// Paths sent to the processes using them
+	vector<vector<int>> received_paths;
+	sparseAllToAll(comm, answers, received_paths);
+
+	for( const auto& ans : received_paths ) {
+		unsigned int i = 0;
+		while( i < ans.size() ) {
+			int len = ans[i + 2];
+			vector<int> path(ans.begin() + i + 3, ans.begin() + i + 3 + len);
+			_near.insert(key(network, ans[i], ans[i + 1]), path);
+			if( delivered != NULL ) (*delivered)[make_pair(ans[i], ans[i + 1])] = std::move(path);
+			i += 3 + len;
+		}
+	}
+
+	return n_computed;
+
+}
+
+
+unsigned int RouteCache::invalidateLinks(const set<int>& links) {
+
+	return _shard.eraseUsing(links) + _near.eraseUsing(links);
+
+}
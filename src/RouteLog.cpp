@@ -0,0 +1,129 @@
+/****************************************************************
+ * ROUTELOG.CPP
+ *
+ * This file contains all the definitions of the methods of
+ * RouteLog.hpp (see this file for methods' documentation)
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+#include <cstring>
+#include <limits>
+#include "../include/RouteLog.hpp"
+
+using namespace std;
+
+static_assert(sizeof(RouteRecord) == 24, "route records must be 24 bytes long");
+
+//! Number of requests buffered before being written.
+static const size_t ROUTE_LOG_BLOCK = 4096;
+
+
+RouteLog::~RouteLog() {
+
+	close();
+
+}
+
+
+bool RouteLog::open(const std::string& filename, const Network& network) {
+
+	_file = fopen( filename.c_str(), "wb" );
+	if( _file == NULL ) return false;
+
+	fwrite("TSRTE001", 1, 8, _file);
+	uint32_t n_nodes = (uint32_t)network.getNNodesIndexed();
+	uint32_t n_links = (uint32_t)network.getNLinksIndexed();
+	fwrite(&n_nodes, 4, 1, _file);
+	fwrite(&n_links, 4, 1, _file);
+	for( int n = 0; n < network.getNNodesIndexed(); n++ ) fwrite(network.getNodeIdByIndex(n).c_str(), 1, network.getNodeIdByIndex(n).size() + 1, _file);
+	for( int l = 0; l < network.getNLinksIndexed(); l++ ) fwrite(network.getLinkIdByIndex(l).c_str(), 1, network.getLinkIdByIndex(l).size() + 1, _file);
+
+	_buffer.reserve(ROUTE_LOG_BLOCK);
+
+	return true;
+
+}
+
+
+void RouteLog::add(const Network& network, RouteSite site, RouteMetric metric, const std::string& source_id, const std::string& dest_id,
+		           const std::string& link_id_to_avoid, float time, double latency, size_t n_links) {
+
+	if( isOpen() == false ) return;
+
+	// nodes and links unknown to the local index (other partitions) are logged as -1
+	RouteRecord record;
+	record.time    = time;
+	record.latency = (uint32_t)min(latency * 1e9, (double)numeric_limits<uint32_t>::max());
+	record.source  = network.getNodes().count(source_id) == 1 ? network.getNodeIndex(source_id) : -1;
+	record.dest    = network.getNodes().count(dest_id) == 1 ? network.getNodeIndex(dest_id) : -1;
+	record.avoid   = link_id_to_avoid.empty() == false && network.getLinks().count(link_id_to_avoid) == 1 ? network.getLinkIndex(link_id_to_avoid) : -1;
+	record.site    = (uint8_t)site;
+	record.metric  = (uint8_t)metric;
+	record.n_links = (uint16_t)min(n_links, (size_t)numeric_limits<uint16_t>::max());
+
+	_buffer.push_back(record);
+	if( _buffer.size() >= ROUTE_LOG_BLOCK ) flush();
+
+}
+
+
+void RouteLog::flush() {
+
+	if( _buffer.empty() == false ) fwrite(_buffer.data(), sizeof(RouteRecord), _buffer.size(), _file);
+	_buffer.clear();
+
+}
+
+
+void RouteLog::close() {
+
+	if( isOpen() == false ) return;
+
+	flush();
+	fclose(_file);
+	_file = NULL;
+
+}
+
+
+bool RouteLog::read(const std::string& filename, std::vector<std::string>& node_ids, std::vector<std::string>& link_ids,
+		            std::vector<RouteRecord>& records) {
+
+	FILE* file = fopen( filename.c_str(), "rb" );
+	if( file == NULL ) return false;
+
+	char     header[8];
+	uint32_t n_nodes = 0, n_links = 0;
+	if( fread(header, 1, 8, file) != 8 || memcmp(header, "TSRTE001", 8) != 0 ||
+		fread(&n_nodes, 4, 1, file) != 1 || fread(&n_links, 4, 1, file) != 1 ) {
+		fclose(file);
+		return false;
+	}
+
+	// ids tables, then the requests until the end of the file
+	auto read_ids = [file](uint32_t n, vector<std::string>& ids) {
+		ids.clear();
+		ids.reserve(n);
+		std::string id;
+		int c;
+		while( ids.size() < n && ( c = fgetc(file) ) != EOF ) {
+			if( c == '\0' ) { ids.push_back(id); id.clear(); }
+			else            id.push_back((char)c);
+		}
+		return ids.size() == n;
+	};
+	if( read_ids(n_nodes, node_ids) == false || read_ids(n_links, link_ids) == false ) {
+		fclose(file);
+		return false;
+	}
+
+	records.clear();
+	vector<RouteRecord> block(ROUTE_LOG_BLOCK);
+	size_t n_read;
+	while( ( n_read = fread(block.data(), sizeof(RouteRecord), ROUTE_LOG_BLOCK, file) ) > 0 ) records.insert(records.end(), block.begin(), block.begin() + n_read);
+
+	fclose(file);
+	return true;
+
+}
@@ -0,0 +1,108 @@
+/****************************************************************
+ * ROUTETASKS.CPP
+ *
+ * This file contains all the definitions of the methods of
+ * RouteTasks.hpp (see this file for methods' documentation)
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+#include "../include/RouteTasks.hpp"
+
+using namespace std;
+
+
+void RouteTasks::publish(const std::string& origin_id, const std::string& dest_id, int deliver_to) {
+
+	if( _published.insert(make_pair(origin_id, dest_id)).second == false ) return;
+
+	_origins.push_back(origin_id);
+	_dests.push_back(dest_id);
+	_deliver_to.push_back(deliver_to);
+
+}
+
+
+unsigned int RouteTasks::run(Network& network, boost::mpi::communicator& comm,
+		                     map<std::string, map<std::string, vector<std::string>>>& paths,
+		                     vector<pair<std::string, std::string>>* delivered, const vector<float>* cost) {
+
+	int n_proc = comm.size();
+	int rank   = comm.rank();
+
+	// Every queue is known by every process
+	vector<vector<std::string>> origins, dests;
+	vector<vector<int>>         deliver_to;
+	boost::mpi::all_gather(comm, _origins, origins);
+	boost::mpi::all_gather(comm, _dests, dests);
+	boost::mpi::all_gather(comm, _deliver_to, deliver_to);
+
+	_origins.clear();
+	_dests.clear();
+	_deliver_to.clear();
+	_published.clear();
+
+	// Counter of the next task to claim in the local queue, exposed to the other processes
+	int next_task = 0;
+	MPI_Win win;
+	MPI_Win_create(&next_task, sizeof(int), sizeof(int), MPI_INFO_NULL, comm, &win);
+	MPI_Win_lock_all(0, win);
+
+	// Results to send, for every process: queue, task, path length and path links index
+	vector<vector<int>> results(n_proc);
+	unsigned int n_computed = 0;
+
+	// Own queue first, then the queues of the next processes
+	for( int k = 0; k < n_proc; k++ ) {
+
+		int victim  = ( rank + k ) % n_proc;
+		int n_tasks = (int)origins[victim].size();
+
+		while( true ) {
+
+			int first = 0;
+			MPI_Fetch_and_op(&_chunk, &first, MPI_INT, victim, 0, MPI_SUM, win);
+			MPI_Win_flush(victim, win);
+			if( first >= n_tasks ) break;
+
+			for( int t = first; t < min(first + _chunk, n_tasks); t++ ) {
+
+				vector<std::string> path = cost == NULL ? network.computePathAStar(origins[victim][t], dests[victim][t])
+				                                        : network.computePath(origins[victim][t], dests[victim][t], *cost);
+
+				vector<int>& res = results[deliver_to[victim][t]];
+				res.push_back(victim);
+				res.push_back(t);
+				res.push_back((int)path.size());
+				for( const auto& l : path ) res.push_back(network.getLinkIndex(l));
+				n_computed++;
+
+			}
+
+		}
+
+	}
+
+	MPI_Win_unlock_all(win);
+	MPI_Win_free(&win);
+
+	// Sending every path to the process using it
+
+	vector<vector<int>> received;
+	boost::mpi::all_to_all(comm, results, received);
+
+	for( const auto& res : received ) {
+		unsigned int i = 0;
+		while( i < res.size() ) {
+			int victim = res[i], t = res[i + 1], len = res[i + 2];
+			vector<std::string>& path = paths[origins[victim][t]][dests[victim][t]];
+			path.clear();
+			for( int j = 0; j < len; j++ ) path.push_back(network.getLinkIdByIndex(res[i + 3 + j]));
+			if( delivered != NULL ) delivered->push_back(make_pair(origins[victim][t], dests[victim][t]));
+			i += 3 + len;
+		}
+	}
+
+	return n_computed;
+
+}
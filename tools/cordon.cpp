@@ -0,0 +1,274 @@
+/****************************************************************
+ * CORDON.CPP
+ *
+ * Subarea extraction: cuts the network to a cordon and converts
+ * the trajectories of a full network run into the trips of the
+ * subarea, entering and leaving it through its boundary.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file cordon.cpp
+ *  \brief Subarea network and demand extraction from a full network run.
+ */
+
+#include <map>
+#include <set>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "../include/tinyxml2.hpp"
+
+using namespace std;
+using namespace tinyxml2;
+
+void usage() {
+	cerr << "usage: cordon network cordon moves_dir output_dir" << endl;
+	cerr << "  network: path to the MATSim network file of the full network run" << endl;
+	cerr << "  cordon: file giving either the polygon of the subarea (one 'x y' vertex per line)" << endl;
+	cerr << "          or its nodes (one node id per line)" << endl;
+	cerr << "  moves_dir: directory of the trajectories of the full network run (moves_proc_*.csv)" << endl;
+	cerr << "  output_dir: directory receiving the subarea network.xml and population.xml" << endl;
+}
+
+//! Split a line given a separator.
+vector<std::string> splitLine(const std::string& line, char sep) {
+
+	vector<std::string> items;
+	std::string item;
+	istringstream stream(line);
+	while( getline(stream, item, sep) ) items.push_back(item);
+
+	return items;
+
+}
+
+//! Check if a point is inside a polygon (crossing number).
+bool isInPolygon(double x, double y, const vector<pair<double,double>>& polygon) {
+
+	bool inside = false;
+	for( unsigned int i = 0, j = (unsigned int)polygon.size() - 1; i < polygon.size(); j = i++ ) {
+		const auto& a = polygon[i];
+		const auto& b = polygon[j];
+		if( ( a.second > y ) != ( b.second > y ) && x < ( b.first - a.first ) * ( y - a.second ) / ( b.second - a.second ) + a.first ) {
+			inside = !inside;
+		}
+	}
+
+	return inside;
+
+}
+
+//! Format a time of the day as hh:mm:ss (MATSim format).
+std::string secToTime(float time) {
+
+	long t = lround(time);
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%02ld:%02ld:%02ld", t / 3600, ( t / 60 ) % 60, t % 60);
+
+	return std::string(buffer);
+
+}
+
+//! A link entered by an agent (one line of the trajectories).
+struct Move {
+	float       time;           //!< time entering the link
+	int         link_on_path;   //!< rank of the link in the path
+	std::string link;           //!< link id
+};
+
+int main(int argc, char ** argv) {
+
+	if( argc < 5 ) {
+		usage();
+		return EXIT_FAILURE;
+	}
+
+	std::string output_dir = argv[4];
+
+	// Cordon: polygon vertices or node ids ---------------------------------
+
+	vector<pair<double,double>> polygon;
+	set<std::string>            cordon_nodes;
+
+	ifstream file_cordon(argv[2], ios::in);
+	if( !file_cordon ) {
+		cerr << "Could not open " << argv[2] << endl;
+		return EXIT_FAILURE;
+	}
+	std::string a_line;
+	while( getline(file_cordon, a_line) ) {
+		istringstream stream(a_line);
+		vector<std::string> items;
+		std::string item;
+		while( stream >> item ) items.push_back(item);
+		if( items.size() == 2 )      polygon.push_back(make_pair(boost::lexical_cast<double>(items[0]), boost::lexical_cast<double>(items[1])));
+		else if( items.size() == 1 ) cordon_nodes.insert(items[0]);
+	}
+	file_cordon.close();
+
+	if( polygon.size() > 0 && polygon.size() < 3 ) {
+		cerr << "A polygon requires at least 3 vertices" << endl;
+		return EXIT_FAILURE;
+	}
+
+	// Network: only the nodes in the cordon and the links between them are kept
+
+	XMLDocument doc;
+	if( doc.loadFile(argv[1]) != XML_SUCCESS ) {
+		cerr << "Could not open " << argv[1] << endl;
+		return EXIT_FAILURE;
+	}
+
+	XMLElement * ele_nodes = doc.FirstChildElement("network")->FirstChildElement("nodes");
+	XMLElement * ele_links = doc.FirstChildElement("network")->FirstChildElement("links");
+
+	set<std::string>    inside;
+	vector<XMLElement*> to_delete;
+	unsigned int n_nodes = 0, n_links = 0;
+
+	for( XMLElement * ele = ele_nodes->FirstChildElement("node"); ele != NULL; ele = ele->NextSiblingElement("node") ) {
+		std::string id = ele->StringAttribute("id");
+		bool is_in = polygon.empty() ? cordon_nodes.count(id) == 1 : isInPolygon(ele->DoubleAttribute("x"), ele->DoubleAttribute("y"), polygon);
+		if( is_in == true ) inside.insert(id);
+		else                to_delete.push_back(ele);
+		n_nodes++;
+	}
+	for( auto ele : to_delete ) ele_nodes->deleteChild(ele);
+	to_delete.clear();
+
+	map<std::string, pair<std::string,std::string>> inside_links;   // start and end nodes of the links kept
+	for( XMLElement * ele = ele_links->FirstChildElement("link"); ele != NULL; ele = ele->NextSiblingElement("link") ) {
+		std::string from = ele->StringAttribute("from");
+		std::string to   = ele->StringAttribute("to");
+		if( inside.count(from) == 1 && inside.count(to) == 1 ) inside_links[ele->StringAttribute("id")] = make_pair(from, to);
+		else                                                  to_delete.push_back(ele);
+		n_links++;
+	}
+	for( auto ele : to_delete ) ele_links->deleteChild(ele);
+
+	cout << "Subarea network: " << inside.size() << " nodes out of " << n_nodes << ", "
+		 << inside_links.size() << " links out of " << n_links << endl;
+
+	if( doc.saveFile( (output_dir + "/network.xml").c_str() ) != XML_SUCCESS ) {
+		cerr << "Could not write " << output_dir << "/network.xml" << endl;
+		return EXIT_FAILURE;
+	}
+
+	// Trajectories in the subarea, by agent and trip ----------------------
+	// (agent id | link id | time entering the link | time on link | path id | link on path)
+
+	map<pair<int,int>, vector<Move>> trajectories;
+	unsigned int n_files = 0;
+
+	for( boost::filesystem::directory_iterator it(argv[3]); it != boost::filesystem::directory_iterator(); ++it ) {
+
+		std::string name = it->path().filename().string();
+		if( name.compare(0, 11, "moves_proc_") != 0 ) continue;
+
+		ifstream file_moves(it->path().string().c_str(), ios::in);
+		while( getline(file_moves, a_line) ) {
+			vector<std::string> data = splitLine(a_line, ';');
+			if( data.size() < 6 || inside_links.count(data[1]) == 0 ) continue;
+			Move move = { boost::lexical_cast<float>(data[2]), boost::lexical_cast<int>(data[5]), data[1] };
+			trajectories[make_pair(boost::lexical_cast<int>(data[0]), boost::lexical_cast<int>(data[4]))].push_back(move);
+		}
+		file_moves.close();
+		n_files++;
+
+	}
+
+	if( n_files == 0 ) {
+		cerr << "No trajectories (moves_proc_*.csv) found in " << argv[3] << endl;
+		return EXIT_FAILURE;
+	}
+
+	// Subarea trips: every run of consecutive links inside the cordon ------
+	// starting when the agent enters the first link of the run, its links being the route of the leg
+
+	XMLDocument plans;
+	plans.insertEndChild(plans.newDeclaration("xml version=\"1.0\" encoding=\"utf-8\""));
+	XMLElement * ele_plans = plans.newElement("plans");
+	plans.insertEndChild(ele_plans);
+
+	unsigned int n_trips = 0, n_trips_internal_start = 0;
+
+	auto add_trip = [&](int agent, int path, int k, const std::string& origin, const std::string& dest, float start_time,
+			            const std::string& route) {
+
+		XMLElement * ele_person = plans.newElement("person");
+		ele_person->SetAttribute("id", ( to_string(agent) + "_" + to_string(path) + "_" + to_string(k) ).c_str());
+		XMLElement * ele_plan = plans.newElement("plan");
+		XMLElement * ele_act_orig = plans.newElement("act");
+		ele_act_orig->SetAttribute("type", "cordon");
+		ele_act_orig->SetAttribute("node_id", origin.c_str());
+		ele_act_orig->SetAttribute("end_time", secToTime(start_time).c_str());
+		XMLElement * ele_leg = plans.newElement("leg");
+		ele_leg->SetAttribute("mode", "car");
+		XMLElement * ele_route = plans.newElement("route");
+		ele_route->SetAttribute("type", "links");
+		ele_route->insertEndChild(plans.newText(route.c_str()));
+		ele_leg->insertEndChild(ele_route);
+		XMLElement * ele_act_dest = plans.newElement("act");
+		ele_act_dest->SetAttribute("type", "cordon");
+		ele_act_dest->SetAttribute("node_id", dest.c_str());
+		ele_plan->insertEndChild(ele_act_orig);
+		ele_plan->insertEndChild(ele_leg);
+		ele_plan->insertEndChild(ele_act_dest);
+		ele_person->insertEndChild(ele_plan);
+		ele_plans->insertEndChild(ele_person);
+
+	};
+
+	for( auto& traj : trajectories ) {
+
+		vector<Move>& moves = traj.second;
+		stable_sort(moves.begin(), moves.end(), [](const Move& a, const Move& b) { return a.time < b.time; });
+
+		unsigned int first = 0;
+		int k = 0;
+		for( unsigned int i = 1; i <= moves.size(); i++ ) {
+
+			// ... the run ends with the trajectory, when the agent left the cordon or if the links do not connect
+			// (the original links of a super link share the same rank in the path)
+			bool run_ends = i == moves.size()
+					|| moves[i].link_on_path > moves[i - 1].link_on_path + 1
+					|| inside_links[moves[i - 1].link].second != inside_links[moves[i].link].first;
+			if( run_ends == false ) continue;
+
+			std::string origin = inside_links[moves[first].link].first;
+			std::string dest   = inside_links[moves[i - 1].link].second;
+			if( origin != dest ) {
+				// ... following the links of the full network run
+				std::string route = moves[first].link;
+				for( unsigned int j = first + 1; j < i; j++ ) route += " " + moves[j].link;
+				add_trip(traj.first.first, traj.first.second, k++, origin, dest, moves[first].time, route);
+				if( moves[first].link_on_path <= 1 ) n_trips_internal_start++;
+				n_trips++;
+			}
+			first = i;
+
+		}
+
+	}
+
+	cout << "Subarea demand: " << n_trips << " trips (" << n_trips_internal_start << " starting inside the cordon, "
+		 << n_trips - n_trips_internal_start << " entering it) from " << trajectories.size() << " trajectories" << endl;
+
+	if( plans.saveFile( (output_dir + "/population.xml").c_str() ) != XML_SUCCESS ) {
+		cerr << "Could not write " << output_dir << "/population.xml" << endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+
+}
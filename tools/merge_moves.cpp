@@ -0,0 +1,313 @@
+/****************************************************************
+ * MERGE_MOVES.CPP
+ *
+ * Parallel merge of the trajectories written by every process of
+ * a run (moves_proc_N.csv) into a single log ordered by the time
+ * the agents enter the links, or into time range shards.
+ *
+ * Date   : 18 october 2026
+ ****************************************************************/
+
+/*! \file merge_moves.cpp
+ *  \brief Parallel k-way merge of the trajectories of every process.
+ *
+ *  Every process of a run writes its trajectories in the order of the
+ *  simulation steps: a row entering a link at time t is written at step t,
+ *  except the rows of the original links of a super link, written with
+ *  the first one and entering their link later. The rows are thus read
+ *  one window of time after the other, the few rows beyond the window
+ *  being kept for the next one, and a row starting a new link of a path
+ *  (a new agent, path or link on path) beyond the window ends the reading.
+ *
+ *  The merge runs in rounds of one window per process: every process
+ *  reads its share of the files up to the end of the round, sends every
+ *  process the rows of its window, and merges the sorted pieces it
+ *  receives (k-way merge). The windows are then written either at their
+ *  offset in the single output file (MPI-IO) or as shards. The memory is
+ *  bounded by the rows of a round.
+ */
+
+#include <queue>
+#include <cmath>
+#include <deque>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <boost/mpi.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+using namespace std;
+
+void usage() {
+	cerr << "usage: mpirun -np P merge_moves moves_dir output [-w window] [-s]" << endl;
+	cerr << "  moves_dir: directory of the trajectories of the run (moves_proc_*.csv)" << endl;
+	cerr << "  output: merged file, or directory receiving the shards (-s)" << endl;
+	cerr << "  -w window: width (s) of the time window merged by every process at once (default 900)" << endl;
+	cerr << "  -s: write one shard moves_START_END.csv per non-empty time window instead of a single file" << endl;
+}
+
+//! A row of the trajectories.
+struct MoveRow {
+
+	float       time;     //!< time entering the link
+	int         source;   //!< process having written the row
+	std::string line;     //!< the row, as written
+
+	//! Serialization of the row.
+	template <class Archive>
+	void serialize ( Archive & ar , const unsigned int version ) {
+		ar & time;
+		ar & source;
+		ar & line;
+	}
+
+};
+
+//! Trajectories written by a process, read one window of time after the other.
+class MovesStream {
+
+private:
+
+	ifstream            _file;       //!< trajectories file
+	int                 _source;     //!< process having written the file
+	std::string         _group;      //!< agent, path and link on path of the last row read
+	vector<MoveRow>     _pending;    //!< rows read beyond the last window (original links of a super link)
+	MoveRow             _lookahead;  //!< first row of a link beyond the last window
+	bool                _has_lookahead;
+
+public:
+
+	MovesStream(const std::string& filename, int source) : _file(filename.c_str(), ios::in), _source(source), _has_lookahead(false) {};
+
+	//! Move the rows entering their link before a given time to a vector.
+	void readUntil(float end, vector<MoveRow>& rows) {
+
+		// ... rows kept from the previous windows
+		auto it = stable_partition(_pending.begin(), _pending.end(), [end](const MoveRow& r) { return r.time < end; });
+		rows.insert(rows.end(), _pending.begin(), it);
+		_pending.erase(_pending.begin(), it);
+
+		if( _has_lookahead == true ) {
+			if( _lookahead.time >= end ) return;
+			rows.push_back(_lookahead);
+			_has_lookahead = false;
+		}
+
+		// agent id | link id | time entering the link | time on link | path id | link on path
+		std::string a_line;
+		while( getline(_file, a_line) ) {
+
+			vector<std::string> data;
+			std::string item;
+			istringstream stream(a_line);
+			while( getline(stream, item, ';') ) data.push_back(item);
+			if( data.size() < 6 ) continue;
+
+			MoveRow row = { boost::lexical_cast<float>(data[2]), _source, a_line };
+			std::string group = data[0] + ";" + data[4] + ";" + data[5];
+			bool new_link = group != _group;
+			_group = group;
+
+			// ... a new link entered after the window: every next row is after it
+			if( new_link == true && row.time >= end ) {
+				_lookahead     = row;
+				_has_lookahead = true;
+				return;
+			}
+
+			if( row.time < end ) rows.push_back(row);
+			else                 _pending.push_back(row);
+
+		}
+
+	}
+
+	//! Return the time of the next row (if any).
+	bool nextTime(float& time) const {
+		if( _has_lookahead == false && _pending.empty() == true ) return false;
+		time = _has_lookahead == true ? _lookahead.time : numeric_limits<float>::max();
+		for( const auto& r : _pending ) time = min(time, r.time);
+		return true;
+	}
+
+	//! Check whether every row has been read.
+	bool isDone() const {
+		return _has_lookahead == false && _pending.empty() == true && _file.eof() == true;
+	}
+
+};
+
+//! Merge the sorted pieces of a window (k-way merge), ties ordered by piece.
+void mergePieces(const vector<vector<MoveRow>>& pieces, std::string& buffer) {
+
+	typedef pair<float, pair<unsigned int, unsigned int>> HeapEntry;    // time, (piece, position in the piece)
+	priority_queue<HeapEntry, vector<HeapEntry>, greater<HeapEntry>> heap;
+
+	for( unsigned int p = 0; p < pieces.size(); p++ ) {
+		if( pieces[p].empty() == false ) heap.push(make_pair(pieces[p][0].time, make_pair(p, 0u)));
+	}
+
+	while( heap.empty() == false ) {
+		unsigned int p = heap.top().second.first;
+		unsigned int i = heap.top().second.second;
+		heap.pop();
+		buffer += pieces[p][i].line;
+		buffer += '\n';
+		if( i + 1 < pieces[p].size() ) heap.push(make_pair(pieces[p][i + 1].time, make_pair(p, i + 1)));
+	}
+
+}
+
+int main(int argc, char ** argv) {
+
+	boost::mpi::environment  env(argc, argv);
+	boost::mpi::communicator world;
+
+	int n_proc = world.size();
+	int rank   = world.rank();
+
+	if( argc < 3 ) {
+		if( rank == 0 ) usage();
+		return EXIT_FAILURE;
+	}
+
+	std::string moves_dir = argv[1];
+	std::string output    = argv[2];
+	float       window    = 900.0f;
+	bool        shards    = false;
+	for( int a = 3; a < argc; a++ ) {
+		std::string arg = argv[a];
+		if( arg == "-w" && a + 1 < argc ) window = boost::lexical_cast<float>(argv[++a]);
+		else if( arg == "-s" )            shards = true;
+	}
+	if( window <= 0.0f ) {
+		if( rank == 0 ) cerr << "The window must be positive" << endl;
+		return EXIT_FAILURE;
+	}
+
+	// Files of the run, shared among the processes ------------------------
+
+	vector<pair<int, std::string>> files;
+	for( boost::filesystem::directory_iterator it(moves_dir); it != boost::filesystem::directory_iterator(); ++it ) {
+		std::string name = it->path().filename().string();
+		if( name.compare(0, 11, "moves_proc_") != 0 || name.size() < 16 ) continue;
+		files.push_back(make_pair(atoi(name.c_str() + 11), it->path().string()));
+	}
+	sort(files.begin(), files.end());
+
+	if( files.empty() == true ) {
+		if( rank == 0 ) cerr << "No trajectories (moves_proc_*.csv) found in " << moves_dir << endl;
+		return EXIT_FAILURE;
+	}
+
+	deque<MovesStream> streams;
+	vector<MoveRow>    no_rows;                                     // (reading up to the first row of every file)
+	float first_time = numeric_limits<float>::max();
+	for( unsigned int f = rank; f < files.size(); f += n_proc ) {
+		streams.emplace_back(files[f].second, files[f].first);
+		streams.back().readUntil(-numeric_limits<float>::max(), no_rows);
+		float t;
+		if( streams.back().nextTime(t) == true ) first_time = min(first_time, t);
+	}
+	first_time = boost::mpi::all_reduce(world, first_time, boost::mpi::minimum<float>());
+	if( first_time == numeric_limits<float>::max() ) first_time = 0.0f;
+
+	// Output --------------------------------------------------------------
+
+	MPI_File file_merged;
+	if( shards == false ) {
+		if( MPI_File_open(world, output.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file_merged) != MPI_SUCCESS ) {
+			if( rank == 0 ) cerr << "Could not open " << output << endl;
+			return EXIT_FAILURE;
+		}
+		MPI_File_set_size(file_merged, 0);
+	}
+
+	// Rounds of one window per process ------------------------------------
+
+	double       round_start = floor(first_time / window) * window;
+	long long    offset      = 0;                                   // size of the merged file so far
+	unsigned int n_shards    = 0;
+	unsigned long long n_rows = 0;
+
+	while( true ) {
+
+		bool done = true;
+		for( const auto& s : streams ) done = done && s.isDone();
+		if( boost::mpi::all_reduce(world, done, std::logical_and<bool>()) == true ) break;
+
+		// ... rows of the round, bucketed by window
+		vector<MoveRow> rows;
+		for( auto& s : streams ) s.readUntil((float)( round_start + n_proc * window ), rows);
+
+		vector<vector<MoveRow>> pieces_out(n_proc), pieces_in;
+		for( auto& r : rows ) {
+			int w = (int)floor( ( r.time - round_start ) / window );
+			pieces_out[max(0, min(w, n_proc - 1))].push_back(std::move(r));
+		}
+		for( auto& p : pieces_out ) stable_sort(p.begin(), p.end(), [](const MoveRow& a, const MoveRow& b) { return a.time < b.time; });
+		rows.clear();
+
+		boost::mpi::all_to_all(world, pieces_out, pieces_in);
+		pieces_out.clear();
+
+		// ... window of the process
+		std::string buffer;
+		mergePieces(pieces_in, buffer);
+		for( const auto& p : pieces_in ) n_rows += p.size();
+		pieces_in.clear();
+
+		double window_start = round_start + rank * window;
+		if( shards == true ) {
+			if( buffer.empty() == false ) {
+				std::string name = output + "/moves_" + to_string((long long)window_start) + "_" + to_string((long long)( window_start + window )) + ".csv";
+				FILE * file_shard = fopen(name.c_str(), "wb");
+				if( file_shard == NULL ) {
+					cerr << "Could not write " << name << endl;
+					world.abort(EXIT_FAILURE);
+				}
+				fwrite(buffer.data(), 1, buffer.size(), file_shard);
+				fclose(file_shard);
+				n_shards++;
+			}
+		}
+		else {
+			// ... windows written at their offset in the merged file
+			vector<long long> sizes;
+			boost::mpi::all_gather(world, (long long)buffer.size(), sizes);
+			long long my_offset = offset;
+			for( int p = 0; p < rank; p++ ) my_offset += sizes[p];
+			for( int p = 0; p < n_proc; p++ ) offset += sizes[p];
+			for( size_t written = 0; written < buffer.size(); ) {
+				int count = (int)min(buffer.size() - written, (size_t)INT_MAX);
+				MPI_File_write_at(file_merged, my_offset + written, buffer.data() + written, count, MPI_BYTE, MPI_STATUS_IGNORE);
+				written += count;
+			}
+		}
+
+		round_start += n_proc * window;
+
+	}
+
+	if( shards == false ) MPI_File_close(&file_merged);
+
+	n_rows   = boost::mpi::all_reduce(world, n_rows, std::plus<unsigned long long>());
+	n_shards = boost::mpi::all_reduce(world, n_shards, std::plus<unsigned int>());
+	if( rank == 0 ) {
+		cout << "Merged " << n_rows << " rows of " << files.size() << " files";
+		if( shards == true ) cout << " into " << n_shards << " shards" << endl;
+		else                 cout << " into " << output << endl;
+	}
+
+	return EXIT_SUCCESS;
+
+}